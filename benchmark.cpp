@@ -0,0 +1,289 @@
+// Микробенчмарки Vector в сравнении с std::vector.
+// Сборка и запуск:
+//     g++ -std=c++20 -O2 -DNDEBUG benchmark.cpp -o benchmark && ./benchmark [max_size] [filter]
+// max_size ограничивает наибольший размер контейнера (по умолчанию 10^6, допустимо до 10^8),
+// filter оставляет только сценарии, в названии которых есть эта подстрока.
+// Для каждого сценария выводится время на один элемент в наносекундах и отношение Vector / std::vector.
+#include "vector.h"
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+using namespace std::literals;
+
+template <typename T>
+void DoNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+struct Pod64 {
+    uint64_t words[8] = {};
+};
+
+// Нетривиальный тип в духе TestObj из тестов: пользовательские операции копирования и деструктор
+struct NonTrivial {
+    NonTrivial() = default;
+    explicit NonTrivial(uint64_t value)
+        : value(value)  //
+    {
+    }
+    NonTrivial(const NonTrivial& other)
+        : value(other.value)  //
+    {
+    }
+    NonTrivial(NonTrivial&& other) noexcept
+        : value(std::exchange(other.value, 0))  //
+    {
+    }
+    NonTrivial& operator=(const NonTrivial& other) {
+        value = other.value;
+        return *this;
+    }
+    NonTrivial& operator=(NonTrivial&& other) noexcept {
+        value = std::exchange(other.value, 0);
+        return *this;
+    }
+    ~NonTrivial() {
+        cookie = 0;
+    }
+    uint64_t value = 0;
+    uint32_t cookie = 0xdeadbeef;
+};
+
+template <typename T>
+T MakeValue(size_t i) {
+    if constexpr (std::is_same_v<T, int>) {
+        return static_cast<int>(i);
+    }
+    else if constexpr (std::is_same_v<T, Pod64>) {
+        Pod64 pod;
+        pod.words[0] = i;
+        return pod;
+    }
+    else if constexpr (std::is_same_v<T, std::string>) {
+        // Длинная строка не помещается в буфер SSO
+        return "benchmark string #"s + std::to_string(i);
+    }
+    else {
+        return T(i);
+    }
+}
+
+// Единый интерфейс для сравниваемых контейнеров
+template <typename T>
+struct StdVectorOps {
+    using Container = std::vector<T>;
+    static constexpr std::string_view NAME = "std::vector"sv;
+    static void PushBack(Container& v, const T& value) { v.push_back(value); }
+    template <typename... Args>
+    static void EmplaceBack(Container& v, Args&&... args) { v.emplace_back(std::forward<Args>(args)...); }
+    static void Reserve(Container& v, size_t n) { v.reserve(n); }
+    static void Insert(Container& v, size_t pos, const T& value) { v.insert(v.begin() + pos, value); }
+    static void Erase(Container& v, size_t pos) { v.erase(v.begin() + pos); }
+    static size_t Size(const Container& v) { return v.size(); }
+};
+
+template <typename T>
+struct VectorOps {
+    using Container = Vector<T>;
+    static constexpr std::string_view NAME = "Vector"sv;
+    static void PushBack(Container& v, const T& value) { v.PushBack(value); }
+    template <typename... Args>
+    static void EmplaceBack(Container& v, Args&&... args) { v.EmplaceBack(std::forward<Args>(args)...); }
+    static void Reserve(Container& v, size_t n) { v.Reserve(n); }
+    static void Insert(Container& v, size_t pos, const T& value) { v.Insert(v.cbegin() + pos, value); }
+    static void Erase(Container& v, size_t pos) { v.Erase(v.cbegin() + pos); }
+    static size_t Size(const Container& v) { return v.Size(); }
+};
+
+// Повторяет run, пока суммарное время замеров не превысит MIN_TIME, и возвращает лучшее время одного запуска.
+// Перед каждым запуском setup готовит состояние, которое передаётся в run; подготовка и разрушение
+// состояния в замер не входят
+template <typename Setup, typename Run>
+double MeasureBestNs(Setup setup, Run run) {
+    using Clock = std::chrono::steady_clock;
+    const auto MIN_TIME = 100ms;
+    const int MIN_RUNS = 3;
+    double best = 0;
+    auto total = Clock::duration::zero();
+    for (int runs = 0; runs < MIN_RUNS || total < MIN_TIME; ++runs) {
+        auto state = setup();
+        const auto start = Clock::now();
+        run(state);
+        const auto elapsed = Clock::now() - start;
+        total += elapsed;
+        const double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+        if (runs == 0 || ns < best) {
+            best = ns;
+        }
+    }
+    return best;
+}
+
+template <typename Run>
+double MeasureBestNs(Run run) {
+    return MeasureBestNs(
+        [] {
+            return 0;
+        },
+        [&run](int) {
+            run();
+        });
+}
+
+template <typename T, typename Ops>
+double BenchPushBack(size_t n) {
+    std::vector<T> values;
+    values.reserve(std::min<size_t>(n, 1024));
+    for (size_t i = 0; i < std::min<size_t>(n, 1024); ++i) {
+        values.push_back(MakeValue<T>(i));
+    }
+    return MeasureBestNs([&] {
+        typename Ops::Container v;
+        for (size_t i = 0; i < n; ++i) {
+            Ops::PushBack(v, values[i % values.size()]);
+        }
+        DoNotOptimize(v);
+    });
+}
+
+template <typename T, typename Ops>
+double BenchEmplaceBack(size_t n) {
+    return MeasureBestNs([&] {
+        typename Ops::Container v;
+        for (size_t i = 0; i < n; ++i) {
+            Ops::EmplaceBack(v, MakeValue<T>(i));
+        }
+        DoNotOptimize(v);
+    });
+}
+
+// Рост через последовательные удвоения Reserve: измеряет только перенос элементов,
+// копия исходного вектора создаётся вне замера
+template <typename T, typename Ops>
+double BenchReserveGrowth(size_t n) {
+    typename Ops::Container source;
+    for (size_t i = 0; i < n; ++i) {
+        Ops::EmplaceBack(source, MakeValue<T>(i));
+    }
+    return MeasureBestNs(
+        [&] {
+            return typename Ops::Container(source);
+        },
+        [n](typename Ops::Container& v) {
+            for (size_t capacity = n * 2; capacity <= n * 16; capacity *= 2) {
+                Ops::Reserve(v, capacity);
+            }
+            DoNotOptimize(v);
+        });
+}
+
+template <typename T, typename Ops>
+double BenchMiddleInsertErase(size_t n) {
+    typename Ops::Container v;
+    for (size_t i = 0; i < n; ++i) {
+        Ops::EmplaceBack(v, MakeValue<T>(i));
+    }
+    const T value = MakeValue<T>(n);
+    const size_t ROUNDS = 16;
+    return MeasureBestNs([&] {
+        for (size_t i = 0; i < ROUNDS; ++i) {
+            Ops::Insert(v, Ops::Size(v) / 2, value);
+        }
+        for (size_t i = 0; i < ROUNDS; ++i) {
+            Ops::Erase(v, Ops::Size(v) / 2);
+        }
+        DoNotOptimize(v);
+    }) / ROUNDS;
+}
+
+template <typename T, typename Ops>
+double BenchCopyAssign(size_t n) {
+    typename Ops::Container source;
+    for (size_t i = 0; i < n; ++i) {
+        Ops::EmplaceBack(source, MakeValue<T>(i));
+    }
+    typename Ops::Container target;
+    return MeasureBestNs([&] {
+        target = source;
+        DoNotOptimize(target);
+    });
+}
+
+template <typename T, typename Ops>
+double BenchIteration(size_t n) {
+    typename Ops::Container v;
+    for (size_t i = 0; i < n; ++i) {
+        Ops::EmplaceBack(v, MakeValue<T>(i));
+    }
+    return MeasureBestNs([&] {
+        size_t checksum = 0;
+        for (const T& value : v) {
+            if constexpr (std::is_same_v<T, int>) {
+                checksum += value;
+            }
+            else if constexpr (std::is_same_v<T, Pod64>) {
+                checksum += value.words[0];
+            }
+            else if constexpr (std::is_same_v<T, std::string>) {
+                checksum += value.size();
+            }
+            else {
+                checksum += value.value;
+            }
+        }
+        DoNotOptimize(checksum);
+    });
+}
+
+void PrintRow(std::string_view scenario, std::string_view type, size_t n, double std_ns, double our_ns,
+              size_t elements) {
+    std::cout << std::left << std::setw(20) << scenario << std::setw(12) << type << std::right << std::setw(11) << n
+              << std::fixed << std::setprecision(2) << std::setw(14) << std_ns / elements << std::setw(14)
+              << our_ns / elements << std::setw(9) << our_ns / std_ns << std::endl;
+}
+
+template <typename T>
+void RunForType(std::string_view type, size_t max_size, std::string_view filter) {
+    // Сценарии с линейной стоимостью операции ограничены, чтобы прогон не занимал часы
+    const size_t MAX_QUADRATIC_SIZE = 100'000;
+    auto run = [&](std::string_view scenario, auto bench_std, auto bench_our, size_t limit, bool per_element) {
+        if (scenario.find(filter) == std::string_view::npos) {
+            return;
+        }
+        for (size_t n = 1; n <= std::min(max_size, limit); n *= 10) {
+            PrintRow(scenario, type, n, bench_std(n), bench_our(n), per_element ? n : 1);
+        }
+    };
+    const size_t UNLIMITED = std::numeric_limits<size_t>::max();
+    run("PushBack"sv, BenchPushBack<T, StdVectorOps<T>>, BenchPushBack<T, VectorOps<T>>, UNLIMITED, true);
+    run("EmplaceBack"sv, BenchEmplaceBack<T, StdVectorOps<T>>, BenchEmplaceBack<T, VectorOps<T>>, UNLIMITED, true);
+    run("ReserveGrowth"sv, BenchReserveGrowth<T, StdVectorOps<T>>, BenchReserveGrowth<T, VectorOps<T>>, UNLIMITED,
+        true);
+    run("MiddleInsertErase"sv, BenchMiddleInsertErase<T, StdVectorOps<T>>, BenchMiddleInsertErase<T, VectorOps<T>>,
+        MAX_QUADRATIC_SIZE, false);
+    run("CopyAssign"sv, BenchCopyAssign<T, StdVectorOps<T>>, BenchCopyAssign<T, VectorOps<T>>, UNLIMITED, true);
+    run("Iteration"sv, BenchIteration<T, StdVectorOps<T>>, BenchIteration<T, VectorOps<T>>, UNLIMITED, true);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const size_t max_size = argc > 1 ? std::stoull(argv[1]) : 1'000'000;
+    const std::string_view filter = argc > 2 ? argv[2] : ""sv;
+
+    std::cout << std::left << std::setw(20) << "scenario" << std::setw(12) << "type" << std::right << std::setw(11)
+              << "size" << std::setw(14) << "std ns/elem" << std::setw(14) << "ours ns/elem" << std::setw(9)
+              << "ratio" << std::endl;
+    RunForType<int>("int"sv, max_size, filter);
+    RunForType<Pod64>("Pod64"sv, max_size, filter);
+    RunForType<std::string>("string"sv, max_size, filter);
+    RunForType<NonTrivial>("NonTrivial"sv, max_size, filter);
+}
@@ -0,0 +1,261 @@
+#pragma once
+#include "vector.h"
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <mutex>
+
+// Пул буферов для векторов, которые создаются и разрушаются в горячих циклах.
+// Запросы округляются вверх до степени двойки байт и обслуживаются из кэша своего класса
+// в текущем потоке, поэтому повторно используются уже тронутые страницы без обращения к malloc.
+// Кэш каждого класса ограничен; при переполнении часть буферов уходит в общий склад,
+// откуда их забирают другие потоки. Так буфер, выделенный в одном потоке и освобождённый
+// в другом, возвращается в оборот, а не копится в кэше освободившего потока.
+// Запросы больше MAX_POOLED_BYTES идут напрямую в operator new.
+namespace buffer_pool_detail {
+
+inline constexpr size_t MIN_CLASS_BITS = 4;
+inline constexpr size_t MAX_CLASS_BITS = 20;
+inline constexpr size_t NUM_CLASSES = MAX_CLASS_BITS - MIN_CLASS_BITS + 1;
+// Предел кэша одного класса в потоке и на складе; хотя бы один буфер кэшируется всегда
+inline constexpr size_t THREAD_CACHE_BYTES_PER_CLASS = size_t{1} << 20;
+inline constexpr size_t DEPOT_BYTES_PER_CLASS = size_t{8} << 20;
+
+struct FreeBlock {
+    FreeBlock* next;
+};
+
+inline size_t ClassOf(size_t bytes) noexcept {
+    return std::max<size_t>(std::bit_width(bytes - 1), MIN_CLASS_BITS) - MIN_CLASS_BITS;
+}
+
+inline size_t ClassBytes(size_t size_class) noexcept {
+    return size_t{1} << (size_class + MIN_CLASS_BITS);
+}
+
+inline size_t MaxCached(size_t size_class, size_t bytes_per_class) noexcept {
+    return std::max<size_t>(bytes_per_class / ClassBytes(size_class), 1);
+}
+
+struct FreeList {
+    FreeBlock* head = nullptr;
+    size_t count = 0;
+
+    void Push(void* p) noexcept {
+        FreeBlock* block = static_cast<FreeBlock*>(p);
+        block->next = head;
+        head = block;
+        ++count;
+    }
+
+    void* Pop() noexcept {
+        FreeBlock* block = head;
+        head = block->next;
+        --count;
+        return block;
+    }
+
+    // Переносит в to не больше n буферов
+    void MoveTo(FreeList& to, size_t n) noexcept {
+        while (n-- != 0 && head != nullptr) {
+            to.Push(Pop());
+        }
+    }
+};
+
+// Общий склад буферов всех потоков. Не разрушается, чтобы им можно было пользоваться
+// из деструкторов статических объектов
+class Depot {
+public:
+    static Depot& Instance() {
+        static Depot* depot = new Depot();
+        return *depot;
+    }
+
+    // Забирает в list до n буферов класса
+    void Take(size_t size_class, FreeList& list, size_t n) noexcept {
+        std::lock_guard lock(mutex_);
+        lists_[size_class].MoveTo(list, n);
+    }
+
+    // Принимает все буферы из list; не поместившиеся на склад освобождаются
+    void Give(size_t size_class, FreeList& list) noexcept {
+        {
+            std::lock_guard lock(mutex_);
+            const size_t limit = MaxCached(size_class, DEPOT_BYTES_PER_CLASS);
+            FreeList& depot_list = lists_[size_class];
+            list.MoveTo(depot_list, limit - std::min(limit, depot_list.count));
+        }
+        while (list.head != nullptr) {
+            operator delete(list.Pop(), ClassBytes(size_class));
+        }
+    }
+
+    size_t CachedBytes() noexcept {
+        std::lock_guard lock(mutex_);
+        size_t bytes = 0;
+        for (size_t i = 0; i != NUM_CLASSES; ++i) {
+            bytes += lists_[i].count * ClassBytes(i);
+        }
+        return bytes;
+    }
+
+private:
+    std::mutex mutex_;
+    std::array<FreeList, NUM_CLASSES> lists_;
+};
+
+class ThreadCache {
+public:
+    // Кэш потока; nullptr, если он уже разрушен при завершении потока
+    static ThreadCache* Current() noexcept {
+        if (state_ == State::DESTROYED) {
+            return nullptr;
+        }
+        thread_local ThreadCache cache;
+        return &cache;
+    }
+
+    ThreadCache() noexcept {
+        state_ = State::ALIVE;
+    }
+
+    ThreadCache(const ThreadCache&) = delete;
+    ThreadCache& operator=(const ThreadCache&) = delete;
+
+    ~ThreadCache() {
+        Trim();
+        state_ = State::DESTROYED;
+    }
+
+    void* Allocate(size_t size_class) {
+        FreeList& list = lists_[size_class];
+        if (list.head == nullptr) {
+            const size_t batch = (MaxCached(size_class, THREAD_CACHE_BYTES_PER_CLASS) + 1) / 2;
+            Depot::Instance().Take(size_class, list, batch);
+            if (list.head == nullptr) {
+                return operator new(ClassBytes(size_class));
+            }
+        }
+        return list.Pop();
+    }
+
+    void Deallocate(void* p, size_t size_class) noexcept {
+        FreeList& list = lists_[size_class];
+        list.Push(p);
+        const size_t limit = MaxCached(size_class, THREAD_CACHE_BYTES_PER_CLASS);
+        if (list.count > limit) {
+            // Половина кэша уходит на склад, чтобы следующие освобождения не обращались к нему сразу
+            FreeList overflow;
+            list.MoveTo(overflow, list.count - limit / 2);
+            Depot::Instance().Give(size_class, overflow);
+        }
+    }
+
+    void Trim() noexcept {
+        for (size_t i = 0; i != NUM_CLASSES; ++i) {
+            if (lists_[i].head != nullptr) {
+                Depot::Instance().Give(i, lists_[i]);
+            }
+        }
+    }
+
+    size_t CachedBytes() const noexcept {
+        size_t bytes = 0;
+        for (size_t i = 0; i != NUM_CLASSES; ++i) {
+            bytes += lists_[i].count * ClassBytes(i);
+        }
+        return bytes;
+    }
+
+private:
+    enum class State : uint8_t {
+        NOT_CREATED,
+        ALIVE,
+        DESTROYED,
+    };
+
+    static inline thread_local constinit State state_ = State::NOT_CREATED;
+
+    std::array<FreeList, NUM_CLASSES> lists_;
+};
+
+}  // namespace buffer_pool_detail
+
+// Управление пулом и его состояние для диагностики
+struct BufferPool {
+    static constexpr size_t MAX_POOLED_BYTES = size_t{1} << buffer_pool_detail::MAX_CLASS_BITS;
+
+    // Отдаёт буферы из кэша текущего потока на общий склад
+    static void TrimThreadCache() noexcept {
+        if (buffer_pool_detail::ThreadCache* cache = buffer_pool_detail::ThreadCache::Current()) {
+            cache->Trim();
+        }
+    }
+
+    static size_t ThreadCachedBytes() noexcept {
+        const buffer_pool_detail::ThreadCache* cache = buffer_pool_detail::ThreadCache::Current();
+        return cache != nullptr ? cache->CachedBytes() : 0;
+    }
+
+    static size_t DepotCachedBytes() noexcept {
+        return buffer_pool_detail::Depot::Instance().CachedBytes();
+    }
+};
+
+// Аллокатор, берущий буферы из BufferPool: Vector<Msg, PooledAllocator<Msg>>
+template <typename T>
+class PooledAllocator {
+    static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "PooledAllocator cannot satisfy the alignment of T");
+
+public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    PooledAllocator() noexcept = default;
+
+    template <typename U>
+    PooledAllocator(const PooledAllocator<U>& /*other*/) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        const size_t bytes = std::max<size_t>(n * sizeof(T), 1);
+        buffer_pool_detail::ThreadCache* cache = buffer_pool_detail::ThreadCache::Current();
+        if (bytes > BufferPool::MAX_POOLED_BYTES || cache == nullptr) {
+            return static_cast<T*>(operator new(PooledBytes(bytes)));
+        }
+        return static_cast<T*>(cache->Allocate(buffer_pool_detail::ClassOf(bytes)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        const size_t bytes = std::max<size_t>(n * sizeof(T), 1);
+        buffer_pool_detail::ThreadCache* cache = buffer_pool_detail::ThreadCache::Current();
+        if (bytes > BufferPool::MAX_POOLED_BYTES || cache == nullptr) {
+            operator delete(p, PooledBytes(bytes));
+            return;
+        }
+        cache->Deallocate(p, buffer_pool_detail::ClassOf(bytes));
+    }
+
+    template <typename U>
+    bool operator==(const PooledAllocator<U>& /*other*/) const noexcept {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const PooledAllocator<U>& /*other*/) const noexcept {
+        return false;
+    }
+
+private:
+    // Размер блока, который выделяется при обращении к operator new в обход кэша.
+    // Блоки классов пула всегда выделяются полного размера класса, чтобы попасть на склад
+    static size_t PooledBytes(size_t bytes) noexcept {
+        return bytes > BufferPool::MAX_POOLED_BYTES ? bytes
+                                                    : buffer_pool_detail::ClassBytes(buffer_pool_detail::ClassOf(bytes));
+    }
+};
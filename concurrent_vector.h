@@ -0,0 +1,221 @@
+#pragma once
+#include "vector.h"
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <stdexcept>
+
+// Вектор с добавлением элементов из многих потоков без блокировок.
+// Элементы хранятся в сегментах, каждый следующий вдвое больше предыдущего, поэтому адреса
+// элементов не меняются, а индекс отображается в сегмент по старшему биту.
+// EmplaceBack резервирует индекс атомарным счётчиком и создаёт элемент на месте;
+// сегмент выделяет первый обратившийся к нему поток. Size() возвращает длину префикса
+// полностью созданных элементов: чтение элементов [0, Size()) не требует синхронизации
+// и не ожидает писателей. Очистка и разрушение вектора не потокобезопасны.
+template <typename T, typename Allocator = std::allocator<T>>
+class ConcurrentVector {
+    enum SlotState : uint8_t { EMPTY, READY, BROKEN };
+
+    // Флаг готовности хранится рядом с элементом: его запись публикует элемент читателям
+    struct Slot {
+        alignas(T) unsigned char storage[sizeof(T)];
+        std::atomic<uint8_t> state{EMPTY};
+
+        T* Get() noexcept {
+            return std::launder(reinterpret_cast<T*>(storage));
+        }
+    };
+
+    using SlotAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Slot>;
+    using SlotTraits = std::allocator_traits<SlotAllocator>;
+
+    static constexpr size_t FIRST_SEGMENT_BITS = 5;
+    static constexpr size_t FIRST_SEGMENT_SIZE = size_t{1} << FIRST_SEGMENT_BITS;
+    static constexpr size_t MAX_SEGMENTS = std::numeric_limits<size_t>::digits - FIRST_SEGMENT_BITS;
+
+public:
+    using allocator_type = Allocator;
+
+    ConcurrentVector() = default;
+
+    explicit ConcurrentVector(const Allocator& alloc) noexcept
+        : alloc_(alloc)
+    {
+    }
+
+    ConcurrentVector(const ConcurrentVector&) = delete;
+    ConcurrentVector& operator=(const ConcurrentVector&) = delete;
+
+    ~ConcurrentVector() {
+        Clear();
+        for (size_t segment = 0; segment != MAX_SEGMENTS; ++segment) {
+            if (Slot* slots = segments_[segment].load(std::memory_order_relaxed)) {
+                DeallocateSegment(slots, segment);
+            }
+        }
+    }
+
+    // Создаёт элемент в конце и возвращает ссылку на него; ссылка действительна до Clear().
+    // Если конструктор или выделение сегмента выбросят исключение, зарезервированная ячейка остаётся пустой
+    // и последующие элементы не попадают в опубликованный префикс, хотя доступны по ссылкам
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        const size_t index = claimed_.fetch_add(1, std::memory_order_relaxed);
+        auto [segment, offset] = Locate(index);
+        Slot& slot = EnsureSegment(segment)[offset];
+        try {
+            new (slot.storage) T(std::forward<Args>(args)...);
+        } catch (...) {
+            slot.state.store(BROKEN, std::memory_order_seq_cst);
+            throw;
+        }
+        slot.state.store(READY, std::memory_order_seq_cst);
+        AdvancePublished();
+        return *slot.Get();
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    // Число элементов, созданных без пропусков от начала вектора
+    size_t Size() const noexcept {
+        return published_.load(std::memory_order_acquire);
+    }
+
+    // Число элементов, для которых уже зарезервированы индексы, включая ещё создаваемые
+    size_t ClaimedSize() const noexcept {
+        return claimed_.load(std::memory_order_relaxed);
+    }
+
+    size_t Capacity() const noexcept {
+        size_t capacity = 0;
+        for (size_t segment = 0; segment != MAX_SEGMENTS && segments_[segment].load(std::memory_order_acquire);
+             ++segment) {
+            capacity += SegmentSize(segment);
+        }
+        return capacity;
+    }
+
+    // Заранее выделяет сегменты под new_capacity элементов. Можно вызывать одновременно с EmplaceBack
+    void Reserve(size_t new_capacity) {
+        if (new_capacity == 0) {
+            return;
+        }
+        const size_t last_segment = Locate(new_capacity - 1).first;
+        for (size_t segment = 0; segment <= last_segment; ++segment) {
+            EnsureSegment(segment);
+        }
+    }
+
+    // Индекс должен быть меньше Size() или принадлежать элементу, созданному этим же потоком
+    T& operator[](size_t index) noexcept {
+        auto [segment, offset] = Locate(index);
+        Slot* slots = segments_[segment].load(std::memory_order_acquire);
+        assert(slots != nullptr);
+        return *slots[offset].Get();
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<ConcurrentVector&>(*this)[index];
+    }
+
+    // Создан ли элемент с индексом index; не требует, чтобы все предыдущие были созданы
+    bool IsPublished(size_t index) const noexcept {
+        if (index >= ClaimedSize()) {
+            return false;
+        }
+        auto [segment, offset] = Locate(index);
+        const Slot* slots = segments_[segment].load(std::memory_order_acquire);
+        return slots != nullptr && slots[offset].state.load(std::memory_order_acquire) == READY;
+    }
+
+    // Разрушает все созданные элементы, сохраняя сегменты
+    void Clear() noexcept {
+        const size_t claimed = claimed_.load(std::memory_order_relaxed);
+        for (size_t index = 0; index != claimed; ++index) {
+            auto [segment, offset] = Locate(index);
+            Slot* slots = segments_[segment].load(std::memory_order_relaxed);
+            if (slots == nullptr) {
+                continue;
+            }
+            if (slots[offset].state.load(std::memory_order_relaxed) == READY) {
+                std::destroy_at(slots[offset].Get());
+            }
+            slots[offset].state.store(EMPTY, std::memory_order_relaxed);
+        }
+        claimed_.store(0, std::memory_order_relaxed);
+        published_.store(0, std::memory_order_release);
+    }
+
+    allocator_type GetAllocator() const noexcept {
+        return allocator_type(alloc_);
+    }
+
+private:
+    [[no_unique_address]] SlotAllocator alloc_;
+    std::array<std::atomic<Slot*>, MAX_SEGMENTS> segments_{};
+    std::atomic<size_t> claimed_ = 0;
+    std::atomic<size_t> published_ = 0;
+
+    static constexpr size_t SegmentSize(size_t segment) noexcept {
+        return FIRST_SEGMENT_SIZE << segment;
+    }
+
+    // Сегмент segment начинается с индекса FIRST_SEGMENT_SIZE * (2^segment - 1)
+    static std::pair<size_t, size_t> Locate(size_t index) noexcept {
+        const size_t shifted = index + FIRST_SEGMENT_SIZE;
+        const size_t segment = std::bit_width(shifted) - 1 - FIRST_SEGMENT_BITS;
+        return {segment, shifted - SegmentSize(segment)};
+    }
+
+    // Выделяет сегмент, если его ещё нет. Из одновременно выделенных устанавливается один,
+    // остальные возвращаются аллокатору. Номер сегмента выходит за MAX_SEGMENTS, только если
+    // индекс переполнился при сдвиге в Locate
+    Slot* EnsureSegment(size_t segment) {
+        if (segment >= MAX_SEGMENTS) {
+            throw std::length_error("ConcurrentVector size exceeded");
+        }
+        Slot* slots = segments_[segment].load(std::memory_order_acquire);
+        if (slots != nullptr) {
+            return slots;
+        }
+        Slot* new_slots = SlotTraits::allocate(alloc_, SegmentSize(segment));
+        std::uninitialized_default_construct_n(new_slots, SegmentSize(segment));
+        if (segments_[segment].compare_exchange_strong(slots, new_slots, std::memory_order_acq_rel,
+                                                       std::memory_order_acquire)) {
+            return new_slots;
+        }
+        DeallocateSegment(new_slots, segment);
+        return slots;
+    }
+
+    void DeallocateSegment(Slot* slots, size_t segment) noexcept {
+        std::destroy_n(slots, SegmentSize(segment));
+        SlotTraits::deallocate(alloc_, slots, SegmentSize(segment));
+    }
+
+    // Сдвигает границу опубликованного префикса через все готовые элементы. Каждый писатель
+    // вызывает её после публикации своего элемента, поэтому граница не застревает перед готовым
+    // элементом: запись состояния и его проверка упорядочены последовательно согласованно
+    void AdvancePublished() noexcept {
+        size_t published = published_.load(std::memory_order_seq_cst);
+        while (published < claimed_.load(std::memory_order_seq_cst)) {
+            auto [segment, offset] = Locate(published);
+            const Slot* slots = segments_[segment].load(std::memory_order_acquire);
+            if (slots == nullptr || slots[offset].state.load(std::memory_order_seq_cst) != READY) {
+                return;
+            }
+            // При неудаче published получает текущее значение, и проверка повторяется с него
+            if (published_.compare_exchange_weak(published, published + 1, std::memory_order_seq_cst)) {
+                ++published;
+            }
+        }
+    }
+};
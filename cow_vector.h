@@ -0,0 +1,243 @@
+#pragma once
+#include "vector.h"
+
+#include <atomic>
+
+// Вектор с копированием при записи. Копии разделяют один блок с элементами и счётчиком ссылок,
+// поэтому копирование стоит O(1), а элементы клонируются при первом изменяющем вызове
+// (неконстантные operator[], begin(), EmplaceBack, Erase и т.д.), если блок разделён.
+// Разные объекты, разделяющие блок, можно использовать из разных потоков, как std::shared_ptr.
+// Ссылки и итераторы, полученные через неконстантный доступ, действуют до следующего копирования вектора.
+template <typename T, typename Allocator = std::allocator<T>>
+class CowVector {
+    struct Block {
+        explicit Block(const Allocator& alloc)
+            : elements(alloc)
+        {
+        }
+
+        Block(const Vector<T, Allocator>& other, const Allocator& alloc)
+            : elements(other, alloc)
+        {
+        }
+
+        std::atomic<size_t> refs = 1;
+        Vector<T, Allocator> elements;
+    };
+
+    using BlockAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Block>;
+    using BlockTraits = std::allocator_traits<BlockAllocator>;
+
+public:
+    using iterator = T*;
+    using const_iterator = const T*;
+    using allocator_type = Allocator;
+
+    CowVector() = default;
+
+    explicit CowVector(const Allocator& alloc) noexcept
+        : alloc_(alloc)
+    {
+    }
+
+    explicit CowVector(size_t size, const Allocator& alloc = Allocator())
+        : CowVector(alloc)
+    {
+        Resize(size);
+    }
+
+    CowVector(const CowVector& other) noexcept
+        : alloc_(other.alloc_)
+        , block_(other.block_)
+    {
+        if (block_ != nullptr) {
+            block_->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    CowVector(CowVector&& other) noexcept
+        : alloc_(other.alloc_)
+        , block_(std::exchange(other.block_, nullptr))
+    {
+    }
+
+    CowVector& operator=(const CowVector& rhs) noexcept {
+        CowVector rhs_copy(rhs);
+        Swap(rhs_copy);
+        return *this;
+    }
+
+    CowVector& operator=(CowVector&& rhs) noexcept {
+        CowVector rhs_moved(std::move(rhs));
+        Swap(rhs_moved);
+        return *this;
+    }
+
+    ~CowVector() {
+        Unref();
+    }
+
+    size_t Size() const noexcept {
+        return block_ != nullptr ? block_->elements.Size() : 0;
+    }
+
+    size_t Capacity() const noexcept {
+        return block_ != nullptr ? block_->elements.Capacity() : 0;
+    }
+
+    // Число векторов, разделяющих элементы с этим; 0 для вектора без блока
+    size_t UseCount() const noexcept {
+        return block_ != nullptr ? block_->refs.load(std::memory_order_relaxed) : 0;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        assert(block_ != nullptr);
+        return std::as_const(block_->elements)[index];
+    }
+
+    T& operator[](size_t index) {
+        return Mutable()[index];
+    }
+
+    std::span<const T> Span() const noexcept {
+        return block_ != nullptr ? std::as_const(block_->elements).Span() : std::span<const T>();
+    }
+
+    void Resize(size_t new_size) {
+        if (new_size != Size()) {
+            Mutable().Resize(new_size);
+        }
+    }
+
+    void Reserve(size_t new_capacity) {
+        if (new_capacity > Capacity()) {
+            Mutable().Reserve(new_capacity);
+        }
+    }
+
+    // Разделённый блок не изменяется: вектор просто отказывается от него
+    void Clear() noexcept {
+        if (UseCount() > 1) {
+            Unref();
+            block_ = nullptr;
+        }
+        else if (block_ != nullptr) {
+            block_->elements.Clear();
+        }
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        CowVector keep_alive = ShareIfShared();
+        return Mutable().EmplaceBack(std::forward<Args>(args)...);
+    }
+
+    void PopBack() {
+        if (Size() != 0) {
+            Mutable().PopBack();
+        }
+    }
+
+    template <typename... Args>
+    iterator Emplace(const_iterator pos, Args&&... args) {
+        const size_t i_pos = pos - cbegin();
+        CowVector keep_alive = ShareIfShared();
+        Vector<T, Allocator>& elements = Mutable();
+        return elements.Emplace(elements.cbegin() + i_pos, std::forward<Args>(args)...);
+    }
+
+    iterator Insert(const_iterator pos, const T& value) {
+        return Emplace(pos, value);
+    }
+
+    iterator Insert(const_iterator pos, T&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    iterator Erase(const_iterator pos) {
+        const size_t i_pos = pos - cbegin();
+        Vector<T, Allocator>& elements = Mutable();
+        return elements.Erase(elements.cbegin() + i_pos);
+    }
+
+    void Swap(CowVector& other) noexcept {
+        if constexpr (std::allocator_traits<Allocator>::propagate_on_container_swap::value) {
+            std::swap(alloc_, other.alloc_);
+        }
+        std::swap(block_, other.block_);
+    }
+
+    allocator_type GetAllocator() const noexcept {
+        return alloc_;
+    }
+
+    // Неконстантные итераторы отделяют вектор от остальных копий
+    iterator begin() { return Mutable().begin(); }
+    iterator end() { return Mutable().end(); }
+    const_iterator begin() const noexcept { return cbegin(); }
+    const_iterator end() const noexcept { return cend(); }
+    const_iterator cbegin() const noexcept { return block_ != nullptr ? std::as_const(block_->elements).begin() : nullptr; }
+    const_iterator cend() const noexcept { return block_ != nullptr ? std::as_const(block_->elements).end() : nullptr; }
+
+    friend bool operator==(const CowVector& lhs, const CowVector& rhs)
+        requires std::equality_comparable<T>
+    {
+        if (lhs.block_ == rhs.block_) {
+            return true;
+        }
+        return std::ranges::equal(lhs.Span(), rhs.Span());
+    }
+
+private:
+    [[no_unique_address]] Allocator alloc_;
+    Block* block_ = nullptr;
+
+    // Возвращает элементы, которыми вектор владеет единолично, при необходимости копируя их.
+    // Если копирование выбросит исключение, вектор продолжает разделять прежний блок
+    Vector<T, Allocator>& Mutable() {
+        if (block_ == nullptr) {
+            block_ = NewBlock(alloc_);
+        }
+        else if (block_->refs.load(std::memory_order_acquire) != 1) {
+            Block* copy = NewBlock(block_->elements, alloc_);
+            Unref();
+            block_ = copy;
+        }
+        return block_->elements;
+    }
+
+    // Аргументы Emplace могут ссылаться на элементы разделённого блока. Пока возвращённая копия жива,
+    // блок не разрушится, даже если остальные владельцы отпустят его во время вызова
+    CowVector ShareIfShared() const noexcept {
+        return UseCount() > 1 ? *this : CowVector(alloc_);
+    }
+
+    template <typename... Args>
+    Block* NewBlock(const Args&... args) {
+        BlockAllocator block_alloc(alloc_);
+        Block* block = BlockTraits::allocate(block_alloc, 1);
+        try {
+            new (block) Block(args...);
+        } catch (...) {
+            BlockTraits::deallocate(block_alloc, block, 1);
+            throw;
+        }
+        return block;
+    }
+
+    void Unref() noexcept {
+        if (block_ != nullptr && block_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            BlockAllocator block_alloc(alloc_);
+            std::destroy_at(block_);
+            BlockTraits::deallocate(block_alloc, block_, 1);
+        }
+    }
+};
@@ -0,0 +1,501 @@
+#pragma once
+#include "vector.h"
+
+#include <functional>
+#include <numeric>
+
+// Упорядоченные ассоциативные контейнеры на отсортированных Vector: FlatSet хранит ключи,
+// FlatMap — ключи и значения в двух отдельных массивах (structure of arrays), поэтому поиск
+// читает только ключи. Поиск — двоичный без ветвлений, вставка и удаление одного элемента
+// сдвигают хвост за O(n). Массовые операции избегают квадратичной сложности: конструктор
+// из неупорядоченных данных сортирует и убирает повторы один раз, а InsertSorted сливает
+// отсортированный диапазон с содержимым за один проход.
+// При повторяющихся ключах остаётся первый встреченный элемент, как при std::map::insert.
+namespace flat_detail {
+
+// Индекс первого ключа, не меньшего key. Шаг цикла не зависит от результата сравнения
+// (компилятор выбирает указатель через cmov), поэтому нет ошибок предсказания переходов
+template <typename K, typename Compare>
+size_t LowerBound(const K* keys, size_t n, const K& key, const Compare& comp) {
+    if (n == 0) {
+        return 0;
+    }
+    const K* base = keys;
+    while (n > 1) {
+        const size_t half = n / 2;
+        base = comp(base[half], key) ? base + half : base;
+        n -= half;
+    }
+    return static_cast<size_t>(base - keys) + (comp(*base, key) ? 1 : 0);
+}
+
+template <typename K, typename Compare>
+bool Equivalent(const K& lhs, const K& rhs, const Compare& comp) {
+    return !comp(lhs, rhs) && !comp(rhs, lhs);
+}
+
+}  // namespace flat_detail
+
+template <typename K, typename Compare = std::less<K>, typename Allocator = std::allocator<K>>
+class FlatSet {
+    using KeyVector = Vector<K, Allocator>;
+
+public:
+    using iterator = const K*;
+    using const_iterator = const K*;
+
+    FlatSet() = default;
+
+    explicit FlatSet(const Compare& comp)
+        : comp_(comp)
+    {
+    }
+
+    // Сортирует и убирает повторы за O(n log n)
+    explicit FlatSet(KeyVector keys, const Compare& comp = Compare())
+        : keys_(std::move(keys))
+        , comp_(comp)
+    {
+        std::stable_sort(keys_.begin(), keys_.end(), comp_);
+        keys_.Erase(std::unique(keys_.begin(), keys_.end(),
+                                [this](const K& lhs, const K& rhs) {
+                                    return flat_detail::Equivalent(lhs, rhs, comp_);
+                                }),
+                    keys_.end());
+    }
+
+    template <std::input_iterator InputIt>
+    FlatSet(InputIt first, InputIt last, const Compare& comp = Compare())
+        : FlatSet(KeyVector(first, last), comp)
+    {
+    }
+
+    size_t Size() const noexcept {
+        return keys_.Size();
+    }
+
+    bool Contains(const K& key) const {
+        return Find(key) != end();
+    }
+
+    const_iterator Find(const K& key) const {
+        const_iterator it = LowerBound(key);
+        return it != end() && !comp_(key, *it) ? it : end();
+    }
+
+    const_iterator LowerBound(const K& key) const {
+        return begin() + flat_detail::LowerBound(keys_.Data(), keys_.Size(), key, comp_);
+    }
+
+    // Возвращает позицию ключа и true, если ключ добавлен
+    std::pair<const_iterator, bool> Insert(const K& key) {
+        return Emplace(key);
+    }
+
+    std::pair<const_iterator, bool> Insert(K&& key) {
+        return Emplace(std::move(key));
+    }
+
+    // Вставляет неупорядоченный диапазон: сортирует его копию и сливает за один проход
+    template <std::input_iterator InputIt>
+    void Insert(InputIt first, InputIt last) {
+        FlatSet batch(first, last, comp_);
+        Merge(std::make_move_iterator(batch.keys_.begin()), std::make_move_iterator(batch.keys_.end()));
+    }
+
+    // Сливает диапазон, упорядоченный по Compare, за O(Size() + n) с одним выделением памяти.
+    // Ключи, которые уже есть в множестве, пропускаются. При исключении множество не меняется
+    template <std::forward_iterator ForwardIt>
+    void InsertSorted(ForwardIt first, ForwardIt last) {
+        assert(std::is_sorted(first, last, comp_));
+        if constexpr (std::is_nothrow_copy_constructible_v<K>) {
+            Merge(first, last);
+        }
+        else {
+            // Копии создаются до слияния, а само слияние только перемещает элементы
+            KeyVector batch(first, last, keys_.GetAllocator());
+            Merge(std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+        }
+    }
+
+    // Возвращает число удалённых ключей (0 или 1)
+    size_t Erase(const K& key) {
+        const_iterator it = Find(key);
+        if (it == end()) {
+            return 0;
+        }
+        Erase(it);
+        return 1;
+    }
+
+    const_iterator Erase(const_iterator pos) {
+        return keys_.Erase(pos);
+    }
+
+    template <typename Predicate>
+    size_t EraseIf(Predicate pred) {
+        return keys_.EraseIf(pred);
+    }
+
+    void Clear() noexcept {
+        keys_.Clear();
+    }
+
+    void Reserve(size_t new_capacity) {
+        keys_.Reserve(new_capacity);
+    }
+
+    std::span<const K> Keys() const noexcept {
+        return keys_.Span();
+    }
+
+    const_iterator begin() const noexcept { return keys_.begin(); }
+    const_iterator end() const noexcept { return keys_.end(); }
+    const_iterator cbegin() const noexcept { return keys_.cbegin(); }
+    const_iterator cend() const noexcept { return keys_.cend(); }
+
+    friend bool operator==(const FlatSet& lhs, const FlatSet& rhs)
+        requires std::equality_comparable<K>
+    {
+        return lhs.keys_ == rhs.keys_;
+    }
+
+private:
+    KeyVector keys_;
+    [[no_unique_address]] Compare comp_;
+
+    template <typename Arg>
+    std::pair<const_iterator, bool> Emplace(Arg&& key) {
+        const_iterator it = LowerBound(key);
+        if (it != end() && !comp_(key, *it)) {
+            return {it, false};
+        }
+        return {keys_.Insert(it, std::forward<Arg>(key)), true};
+    }
+
+    // Сливает упорядоченный диапазон с содержимым. Элементы множества перемещаются,
+    // только если перемещение не выбрасывает исключений
+    template <typename ForwardIt>
+    void Merge(ForwardIt first, ForwardIt last) {
+        if (first == last) {
+            return;
+        }
+        KeyVector merged(keys_.GetAllocator());
+        merged.Reserve(keys_.Size() + static_cast<size_t>(std::distance(first, last)));
+        K* existing = keys_.begin();
+        K* const existing_end = keys_.end();
+        while (first != last) {
+            if (existing != existing_end && !comp_(*first, *existing)) {
+                if (!comp_(*existing, *first)) {
+                    ++first;  // ключ уже есть
+                    continue;
+                }
+                merged.EmplaceBack(std::move_if_noexcept(*existing++));
+            }
+            else if (merged.Size() == 0 || comp_(merged[merged.Size() - 1], *first)) {
+                merged.EmplaceBack(*first++);
+            }
+            else {
+                ++first;  // повтор внутри диапазона
+            }
+        }
+        for (; existing != existing_end; ++existing) {
+            merged.EmplaceBack(std::move_if_noexcept(*existing));
+        }
+        keys_.Swap(merged);
+    }
+};
+
+template <typename K, typename V, typename Compare = std::less<K>, typename KeyAllocator = std::allocator<K>,
+          typename ValueAllocator = std::allocator<V>>
+class FlatMap {
+    using KeyVector = Vector<K, KeyAllocator>;
+    using ValueVector = Vector<V, ValueAllocator>;
+
+public:
+    FlatMap() = default;
+
+    explicit FlatMap(const Compare& comp)
+        : comp_(comp)
+    {
+    }
+
+    // Строит словарь из параллельных массивов ключей и значений за O(n log n).
+    // Сортировка устойчива, поэтому из повторяющихся ключей остаётся первый
+    FlatMap(KeyVector keys, ValueVector values, const Compare& comp = Compare())
+        : keys_(keys.GetAllocator())
+        , values_(values.GetAllocator())
+        , comp_(comp)
+    {
+        assert(keys.Size() == values.Size());
+        Vector<size_t> order(keys.Size());
+        std::iota(order.begin(), order.end(), size_t{0});
+        std::stable_sort(order.begin(), order.end(), [&keys, this](size_t lhs, size_t rhs) {
+            return comp_(keys[lhs], keys[rhs]);
+        });
+        keys_.Reserve(keys.Size());
+        values_.Reserve(values.Size());
+        for (size_t index : order) {
+            if (keys_.Size() == 0 || comp_(keys_[keys_.Size() - 1], keys[index])) {
+                keys_.EmplaceBack(std::move(keys[index]));
+                values_.EmplaceBack(std::move(values[index]));
+            }
+        }
+    }
+
+    // Диапазон пар ключ-значение в любом порядке
+    template <std::input_iterator InputIt>
+    FlatMap(InputIt first, InputIt last, const Compare& comp = Compare())
+        : FlatMap(SplitPairs(first, last), comp)
+    {
+    }
+
+    size_t Size() const noexcept {
+        return keys_.Size();
+    }
+
+    bool Contains(const K& key) const {
+        return Find(key) != nullptr;
+    }
+
+    // Указатель на значение ключа или nullptr
+    V* Find(const K& key) {
+        const size_t index = IndexOf(key);
+        return index != Size() ? &values_[index] : nullptr;
+    }
+
+    const V* Find(const K& key) const {
+        return const_cast<FlatMap&>(*this).Find(key);
+    }
+
+    // Вставляет значение, созданное по умолчанию, если ключа нет
+    V& operator[](const K& key) {
+        return *TryEmplace(key).first;
+    }
+
+    // Создаёт значение из args, только если ключа ещё нет. Возвращает значение ключа и true, если оно добавлено
+    template <typename... Args>
+    std::pair<V*, bool> TryEmplace(const K& key, Args&&... args) {
+        const size_t index = flat_detail::LowerBound(keys_.Data(), keys_.Size(), key, comp_);
+        if (index != Size() && !comp_(key, keys_[index])) {
+            return {&values_[index], false};
+        }
+        values_.Emplace(values_.cbegin() + index, std::forward<Args>(args)...);
+        try {
+            keys_.Insert(keys_.cbegin() + index, key);
+        } catch (...) {
+            values_.Erase(values_.cbegin() + index);
+            throw;
+        }
+        return {&values_[index], true};
+    }
+
+    // Вставляет или заменяет значение ключа
+    template <typename Arg>
+    V& InsertOrAssign(const K& key, Arg&& value) {
+        auto [slot, inserted] = TryEmplace(key, std::forward<Arg>(value));
+        if (!inserted) {
+            *slot = std::forward<Arg>(value);
+        }
+        return *slot;
+    }
+
+    // Вставляет неупорядоченный диапазон пар: сортирует его копию и сливает за один проход
+    template <std::input_iterator InputIt>
+    void Insert(InputIt first, InputIt last) {
+        FlatMap batch(first, last, comp_);
+        MergeSorted(std::make_move_iterator(batch.keys_.begin()), std::make_move_iterator(batch.keys_.end()),
+                    std::make_move_iterator(batch.values_.begin()));
+    }
+
+    // Сливает диапазон пар, упорядоченный по ключам, за O(Size() + n) с одним выделением памяти
+    // на каждый массив. Ключи, которые уже есть в словаре, пропускаются. При исключении словарь не меняется
+    template <std::forward_iterator ForwardIt>
+    void InsertSorted(ForwardIt first, ForwardIt last) {
+        assert(std::is_sorted(first, last, [this](const auto& lhs, const auto& rhs) {
+            return comp_(lhs.first, rhs.first);
+        }));
+        if constexpr (std::is_nothrow_copy_constructible_v<K> && std::is_nothrow_copy_constructible_v<V>) {
+            MergeSorted(first, last, nullptr);
+        }
+        else {
+            // Копии создаются до слияния, а само слияние только перемещает элементы
+            SplitResult batch = SplitPairs(first, last);
+            MergeSorted(std::make_move_iterator(batch.keys.begin()), std::make_move_iterator(batch.keys.end()),
+                        std::make_move_iterator(batch.values.begin()));
+        }
+    }
+
+    // Возвращает число удалённых элементов (0 или 1)
+    size_t Erase(const K& key) {
+        const size_t index = IndexOf(key);
+        if (index == Size()) {
+            return 0;
+        }
+        keys_.Erase(keys_.cbegin() + index);
+        values_.Erase(values_.cbegin() + index);
+        return 1;
+    }
+
+    // Удаляет элементы, для которых pred(key, value) истинно, за один проход уплотнения
+    template <typename Predicate>
+    size_t EraseIf(Predicate pred) {
+        size_t kept = 0;
+        for (size_t i = 0; i != Size(); ++i) {
+            if (!pred(std::as_const(keys_[i]), values_[i])) {
+                if (kept != i) {
+                    keys_[kept] = std::move(keys_[i]);
+                    values_[kept] = std::move(values_[i]);
+                }
+                ++kept;
+            }
+        }
+        const size_t n_removed = Size() - kept;
+        keys_.Erase(keys_.cbegin() + kept, keys_.cend());
+        values_.Erase(values_.cbegin() + kept, values_.cend());
+        return n_removed;
+    }
+
+    void Clear() noexcept {
+        keys_.Clear();
+        values_.Clear();
+    }
+
+    void Reserve(size_t new_capacity) {
+        keys_.Reserve(new_capacity);
+        values_.Reserve(new_capacity);
+    }
+
+    // Ключи и значения по возрастанию ключей; i-е значение принадлежит i-му ключу
+    std::span<const K> Keys() const noexcept {
+        return keys_.Span();
+    }
+
+    std::span<V> Values() noexcept {
+        return values_.Span();
+    }
+
+    std::span<const V> Values() const noexcept {
+        return values_.Span();
+    }
+
+    friend bool operator==(const FlatMap& lhs, const FlatMap& rhs)
+        requires std::equality_comparable<K> && std::equality_comparable<V>
+    {
+        return lhs.keys_ == rhs.keys_ && lhs.values_ == rhs.values_;
+    }
+
+private:
+    KeyVector keys_;
+    ValueVector values_;
+    [[no_unique_address]] Compare comp_;
+
+    struct SplitResult {
+        KeyVector keys;
+        ValueVector values;
+    };
+
+    FlatMap(SplitResult split, const Compare& comp)
+        : FlatMap(std::move(split.keys), std::move(split.values), comp)
+    {
+    }
+
+    template <typename InputIt>
+    static SplitResult SplitPairs(InputIt first, InputIt last) {
+        SplitResult split;
+        if constexpr (std::forward_iterator<InputIt>) {
+            const size_t n = static_cast<size_t>(std::distance(first, last));
+            split.keys.Reserve(n);
+            split.values.Reserve(n);
+        }
+        for (; first != last; ++first) {
+            split.keys.EmplaceBack(first->first);
+            split.values.EmplaceBack(first->second);
+        }
+        return split;
+    }
+
+    size_t IndexOf(const K& key) const {
+        const size_t index = flat_detail::LowerBound(keys_.Data(), keys_.Size(), key, comp_);
+        return index != Size() && !comp_(key, keys_[index]) ? index : Size();
+    }
+
+    // Сливает отсортированные пары. Если values == nullptr, first указывает на пары ключ-значение,
+    // иначе first — ключи, а values — соответствующие им значения. Элементы словаря перемещаются,
+    // только если без исключений перемещаются и ключи, и значения: иначе исключение при переносе
+    // значения оставило бы словарь с уже перемещённым ключом
+    template <typename ForwardIt, typename ValueIt>
+    void MergeSorted(ForwardIt first, ForwardIt last, ValueIt values) {
+        constexpr bool IS_PAIRS = std::is_same_v<ValueIt, std::nullptr_t>;
+        constexpr bool MOVE_EXISTING =
+            (std::is_nothrow_move_constructible_v<K> && std::is_nothrow_move_constructible_v<V>)
+            || !(std::is_copy_constructible_v<K> && std::is_copy_constructible_v<V>);
+        if (first == last) {
+            return;
+        }
+        const size_t n = static_cast<size_t>(std::distance(first, last));
+        KeyVector merged_keys(keys_.GetAllocator());
+        ValueVector merged_values(values_.GetAllocator());
+        merged_keys.Reserve(keys_.Size() + n);
+        merged_values.Reserve(values_.Size() + n);
+
+        auto key_of = [](ForwardIt it) -> const K& {
+            if constexpr (IS_PAIRS) {
+                return it->first;
+            }
+            else {
+                return *it;
+            }
+        };
+        auto take_new = [&] {
+            if constexpr (IS_PAIRS) {
+                merged_keys.EmplaceBack(first->first);
+                merged_values.EmplaceBack(first->second);
+            }
+            else {
+                merged_keys.EmplaceBack(*first);
+                merged_values.EmplaceBack(*values);
+            }
+        };
+        auto take_existing = [&](size_t index) {
+            if constexpr (MOVE_EXISTING) {
+                merged_keys.EmplaceBack(std::move(keys_[index]));
+                merged_values.EmplaceBack(std::move(values_[index]));
+            }
+            else {
+                merged_keys.EmplaceBack(keys_[index]);
+                merged_values.EmplaceBack(values_[index]);
+            }
+        };
+        auto skip_new = [&] {
+            ++first;
+            if constexpr (!IS_PAIRS) {
+                ++values;
+            }
+        };
+
+        size_t existing = 0;
+        while (first != last) {
+            if (existing != Size() && !comp_(key_of(first), keys_[existing])) {
+                if (!comp_(keys_[existing], key_of(first))) {
+                    skip_new();  // ключ уже есть
+                    continue;
+                }
+                take_existing(existing);
+                ++existing;
+            }
+            else if (merged_keys.Size() == 0 || comp_(merged_keys[merged_keys.Size() - 1], key_of(first))) {
+                take_new();
+                skip_new();
+            }
+            else {
+                skip_new();  // повтор внутри диапазона
+            }
+        }
+        for (; existing != Size(); ++existing) {
+            take_existing(existing);
+        }
+        keys_.Swap(merged_keys);
+        values_.Swap(merged_values);
+    }
+};
@@ -0,0 +1,188 @@
+#pragma once
+#include "vector.h"
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <cstdint>
+
+// Настройки HugePageAllocator
+struct HugePageOptions {
+    // Буферы от этого размера выделяются через mmap, меньшие — через std::allocator
+    size_t threshold_bytes = size_t{4} << 20;
+    // Предпочтительный узел NUMA для страниц большого буфера; -1 — на усмотрение ядра
+    int numa_node = -1;
+    // Сначала пробовать зарезервированные страницы hugetlbfs (MAP_HUGETLB)
+    bool use_hugetlb = false;
+};
+
+namespace hugepage_detail {
+
+inline constexpr size_t HUGE_PAGE_SIZE = size_t{2} << 20;
+
+inline size_t MappedBytes(size_t bytes) noexcept {
+    return (bytes + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+}
+
+#ifdef __linux__
+
+// Режим MPOL_PREFERRED из <numaif.h>; сам заголовок входит в libnuma и может отсутствовать
+inline constexpr int MPOL_PREFERRED_MODE = 1;
+
+// Просит ядро размещать ещё не тронутые страницы на узле node. Это подсказка:
+// при ошибке (например, узла нет) страницы размещаются как обычно
+inline void BindToNode(void* p, size_t bytes, int node) noexcept {
+    if (node < 0 || node >= static_cast<int>(sizeof(unsigned long) * 8)) {
+        return;
+    }
+    const unsigned long node_mask = 1UL << node;
+    ::syscall(SYS_mbind, p, bytes, MPOL_PREFERRED_MODE, &node_mask, sizeof(node_mask) * 8 + 1, 0U);
+}
+
+// Заводит отображение и просит прозрачные огромные страницы для него
+inline void Advise(void* p, size_t bytes, const HugePageOptions& options) noexcept {
+    ::madvise(p, bytes, MADV_HUGEPAGE);
+    BindToNode(p, bytes, options.numa_node);
+}
+
+// Анонимное отображение, выровненное по границе огромной страницы: без выравнивания ядро
+// не может отдать огромными страницами его начало и конец
+inline void* Map(size_t bytes, const HugePageOptions& options) {
+    const size_t mapped_bytes = MappedBytes(bytes);
+    if (options.use_hugetlb) {
+        void* p = ::mmap(nullptr, mapped_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+                         -1, 0);
+        if (p != MAP_FAILED) {
+            BindToNode(p, mapped_bytes, options.numa_node);
+            return p;
+        }
+    }
+    void* raw = ::mmap(nullptr, mapped_bytes + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                       -1, 0);
+    if (raw == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+    const uintptr_t raw_address = reinterpret_cast<uintptr_t>(raw);
+    const uintptr_t address = (raw_address + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+    if (address != raw_address) {
+        ::munmap(raw, address - raw_address);
+    }
+    if (const size_t tail = raw_address + HUGE_PAGE_SIZE - address; tail != 0) {
+        ::munmap(reinterpret_cast<void*>(address + mapped_bytes), tail);
+    }
+    void* p = reinterpret_cast<void*>(address);
+    Advise(p, mapped_bytes, options);
+    return p;
+}
+
+inline void Unmap(void* p, size_t bytes) noexcept {
+    ::munmap(p, MappedBytes(bytes));
+}
+
+// Меняет размер отображения без копирования; nullptr, если ядро не смогло
+inline void* Remap(void* p, size_t old_bytes, size_t new_bytes, const HugePageOptions& options) noexcept {
+    void* new_p = ::mremap(p, MappedBytes(old_bytes), MappedBytes(new_bytes), MREMAP_MAYMOVE);
+    if (new_p == MAP_FAILED) {
+        return nullptr;
+    }
+    Advise(new_p, MappedBytes(new_bytes), options);
+    return new_p;
+}
+
+#endif
+
+}  // namespace hugepage_detail
+
+// Аллокатор для очень больших векторов. Буферы от options.threshold_bytes выделяются отдельным
+// анонимным отображением, выровненным по 2 МиБ и помеченным MADV_HUGEPAGE, и при необходимости
+// привязываются к узлу NUMA через mbind; меньшие буферы выделяет std::allocator.
+// Метод reallocate увеличивает большой буфер через mremap, поэтому Vector с тривиально
+// перемещаемыми элементами растёт без копирования. Вне Linux все буферы выделяет std::allocator.
+template <typename T>
+class HugePageAllocator {
+    static_assert(alignof(T) <= 4096, "HugePageAllocator cannot satisfy the alignment of T");
+
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    HugePageAllocator() noexcept = default;
+
+    explicit HugePageAllocator(const HugePageOptions& options) noexcept
+        : options_(options)
+    {
+    }
+
+    template <typename U>
+    HugePageAllocator(const HugePageAllocator<U>& other) noexcept
+        : options_(other.GetOptions())
+    {
+    }
+
+    const HugePageOptions& GetOptions() const noexcept {
+        return options_;
+    }
+
+    T* allocate(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+#ifdef __linux__
+        if (IsLarge(n)) {
+            return static_cast<T*>(hugepage_detail::Map(n * sizeof(T), options_));
+        }
+#endif
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+#ifdef __linux__
+        if (IsLarge(n)) {
+            hugepage_detail::Unmap(p, n * sizeof(T));
+            return;
+        }
+#endif
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    // Большой буфер переотображается через mremap; при переходе через порог байты копируются
+    T* reallocate(T* p, size_t old_n, size_t new_n) {
+        if (new_n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+#ifdef __linux__
+        if (IsLarge(old_n) && IsLarge(new_n)) {
+            if (void* new_p = hugepage_detail::Remap(p, old_n * sizeof(T), new_n * sizeof(T), options_)) {
+                return static_cast<T*>(new_p);
+            }
+        }
+#endif
+        T* new_p = allocate(new_n);
+        std::memcpy(static_cast<void*>(new_p), static_cast<const void*>(p), std::min(old_n, new_n) * sizeof(T));
+        deallocate(p, old_n);
+        return new_p;
+    }
+
+    // Способ освобождения зависит от порога, поэтому аллокаторы с разными порогами не взаимозаменяемы
+    template <typename U>
+    bool operator==(const HugePageAllocator<U>& other) const noexcept {
+        return options_.threshold_bytes == other.GetOptions().threshold_bytes;
+    }
+
+    template <typename U>
+    bool operator!=(const HugePageAllocator<U>& other) const noexcept {
+        return !(*this == other);
+    }
+
+private:
+    HugePageOptions options_;
+
+    bool IsLarge(size_t n) const noexcept {
+        return n * sizeof(T) >= options_.threshold_bytes;
+    }
+};
@@ -1,8 +1,37 @@
 #include "vector.h"
+#include "bit_vector.h"
+#include "buffer_pool.h"
+#include "concurrent_vector.h"
+#include "cow_vector.h"
+#include "flat_map.h"
+#include "hugepage_allocator.h"
+#include "mapped_vector.h"
+#include "persistent_vector.h"
+#include "segmented_vector.h"
+#include "vector_algorithms.h"
+#include "vector_ranges.h"
+#include "small_vector.h"
+#include "soa_vector.h"
+#include "static_vector.h"
+#include "streaming_fill.h"
+#include "vector_serialization.h"
+#include "vector_stats.h"
 
+#include <atomic>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <latch>
+#include <list>
+#include <map>
+#include <memory_resource>
+#include <numeric>
+#include <random>
+#include <ranges>
+#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace {
@@ -116,8 +145,266 @@ struct Obj {
     static inline int num_move_assigned = 0;
 };
 
+// Аллокатор с состоянием, считающий число живых выделений в своей "арене"
+template <typename T>
+struct ArenaAllocator {
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    explicit ArenaAllocator(int* live_allocations)
+        : live_allocations(live_allocations)  //
+    {
+    }
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept
+        : live_allocations(other.live_allocations)  //
+    {
+    }
+
+    T* allocate(size_t n) {
+        ++*live_allocations;
+        return std::allocator<T>{}.allocate(n);
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        --*live_allocations;
+        std::allocator<T>{}.deallocate(p, n);
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const noexcept {
+        return live_allocations == other.live_allocations;
+    }
+
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const noexcept {
+        return !(*this == other);
+    }
+
+    int* live_allocations;
+};
+
+// Аллокатор арены, который переходит к получателю при копирующем присваивании,
+// но не при перемещающем присваивании и обмене
+template <typename T>
+struct CopyPropagatingArenaAllocator : ArenaAllocator<T> {
+    using propagate_on_container_move_assignment = std::false_type;
+    using propagate_on_container_swap = std::false_type;
+
+    explicit CopyPropagatingArenaAllocator(int* live_allocations)
+        : ArenaAllocator<T>(live_allocations)  //
+    {
+    }
+
+    template <typename U>
+    CopyPropagatingArenaAllocator(const CopyPropagatingArenaAllocator<U>& other) noexcept
+        : ArenaAllocator<T>(other)  //
+    {
+    }
+};
+
+// Считает живые объекты атомарно, чтобы их можно было создавать и разрушать из разных потоков
+struct AtomicObj {
+    AtomicObj() noexcept {
+        ++num_alive;
+    }
+
+    explicit AtomicObj(int id) noexcept
+        : id(id)  //
+    {
+        ++num_alive;
+    }
+
+    AtomicObj(const AtomicObj& other)
+        : id(other.id)  //
+    {
+        if (other.throw_on_copy) {
+            throw std::runtime_error("Oops");
+        }
+        ++num_alive;
+    }
+
+    AtomicObj& operator=(const AtomicObj& other) = default;
+
+    ~AtomicObj() {
+        --num_alive;
+    }
+
+    bool throw_on_copy = false;
+    int id = 0;
+
+    static inline std::atomic<int> num_alive = 0;
+};
+
+// Внедрение отказов: взведённый счётчик заставляет N-е выделение памяти через FailingAllocator
+// или N-е создание FuzzValue выбросить исключение. Счётчики атомарны, чтобы отказы можно было
+// внедрять и в параллельные операции
+struct FailureInjection {
+    static void ArmAllocation(int n) noexcept {
+        Disarm();
+        allocation_countdown = n;
+    }
+
+    static void ArmConstruction(int n) noexcept {
+        Disarm();
+        construction_countdown = n;
+    }
+
+    static void Disarm() noexcept {
+        allocation_countdown = 0;
+        construction_countdown = 0;
+        fired = false;
+    }
+
+    static void OnAllocation() {
+        if (Tick(allocation_countdown)) {
+            throw std::bad_alloc();
+        }
+    }
+
+    static void OnConstruction() {
+        if (Tick(construction_countdown)) {
+            throw std::runtime_error("Injected failure");
+        }
+    }
+
+    static inline std::atomic<int> allocation_countdown = 0;
+    static inline std::atomic<int> construction_countdown = 0;
+    // Был ли отказ после последнего взведения
+    static inline std::atomic<bool> fired = false;
+    static inline std::atomic<int> live_allocations = 0;
+
+private:
+    static bool Tick(std::atomic<int>& countdown) noexcept {
+        int n = countdown.load();
+        while (n > 0 && !countdown.compare_exchange_weak(n, n - 1)) {
+        }
+        if (n != 1) {
+            return false;
+        }
+        fired = true;
+        return true;
+    }
+};
+
+// Аллокатор, в котором могут случаться отказы. WithReallocate добавляет метод reallocate,
+// чтобы проверить и рост буфера на месте
+template <typename T, bool WithReallocate = false>
+struct FailingAllocator {
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    template <typename U>
+    struct rebind {
+        using other = FailingAllocator<U, WithReallocate>;
+    };
+
+    FailingAllocator() noexcept = default;
+
+    template <typename U>
+    FailingAllocator(const FailingAllocator<U, WithReallocate>& /*other*/) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        FailureInjection::OnAllocation();
+        T* p = std::allocator<T>{}.allocate(n);
+        ++FailureInjection::live_allocations;
+        return p;
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        --FailureInjection::live_allocations;
+        std::allocator<T>{}.deallocate(p, n);
+    }
+
+    T* reallocate(T* p, size_t old_n, size_t new_n)
+        requires WithReallocate
+    {
+        T* new_p = allocate(new_n);
+        std::memcpy(static_cast<void*>(new_p), static_cast<const void*>(p), std::min(old_n, new_n) * sizeof(T));
+        deallocate(p, old_n);
+        return new_p;
+    }
+
+    template <typename U>
+    bool operator==(const FailingAllocator<U, WithReallocate>& /*other*/) const noexcept {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const FailingAllocator<U, WithReallocate>& /*other*/) const noexcept {
+        return false;
+    }
+};
+
+// Элемент, создание и присваивание которого могут завершиться внедрённым отказом.
+// Relocatable помечает тип тривиально перемещаемым, NothrowMove делает перемещение
+// не выбрасывающим исключений. Перемещённый объект получает значение MOVED_FROM,
+// поэтому потерянные при откате элементы видны при сравнении
+template <bool Relocatable, bool NothrowMove>
+struct FuzzValue {
+    static constexpr int MOVED_FROM = -1;
+
+    FuzzValue() {
+        FailureInjection::OnConstruction();
+        ++num_alive;
+    }
+
+    explicit FuzzValue(int value)
+        : value(value)  //
+    {
+        FailureInjection::OnConstruction();
+        ++num_alive;
+    }
+
+    FuzzValue(const FuzzValue& other)
+        : value(other.value)  //
+    {
+        FailureInjection::OnConstruction();
+        ++num_alive;
+    }
+
+    FuzzValue(FuzzValue&& other) noexcept(NothrowMove)
+        : value(other.value)  //
+    {
+        if constexpr (!NothrowMove) {
+            FailureInjection::OnConstruction();
+        }
+        other.value = MOVED_FROM;
+        ++num_alive;
+    }
+
+    FuzzValue& operator=(const FuzzValue& other) {
+        FailureInjection::OnConstruction();
+        value = other.value;
+        return *this;
+    }
+
+    FuzzValue& operator=(FuzzValue&& other) noexcept(NothrowMove) {
+        if constexpr (!NothrowMove) {
+            FailureInjection::OnConstruction();
+        }
+        value = std::exchange(other.value, MOVED_FROM);
+        return *this;
+    }
+
+    ~FuzzValue() {
+        --num_alive;
+    }
+
+    int value = 0;
+
+    static inline std::atomic<int> num_alive = 0;
+};
+
 }  // namespace
 
+template <bool NothrowMove>
+struct IsTriviallyRelocatable<FuzzValue<true, NothrowMove>> : std::true_type {};
+
 void Test1() {
     Obj::ResetCounters();
     const size_t SIZE = 100500;
@@ -558,84 +845,2538 @@ void Test6() {
     }
 }
 
-struct C {
-    C() noexcept {
-        ++def_ctor;
+void Test7() {
+    const size_t SIZE = 100;
+    {
+        Vector<std::unique_ptr<int>> v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.EmplaceBack(std::make_unique<int>(static_cast<int>(i)));
+        }
+        v.Emplace(v.cbegin() + 1, std::make_unique<int>(-1));
+        v.Reserve(SIZE * 4);
+        assert(v.Size() == SIZE + 1);
+        assert(*v[0] == 0);
+        assert(*v[1] == -1);
+        assert(*v[SIZE] == static_cast<int>(SIZE - 1));
     }
-    C(const C& /*other*/) noexcept {
-        ++copy_ctor;
+    {
+        static_assert(IsTriviallyRelocatable<int>::value);
+        static_assert(IsTriviallyRelocatable<std::unique_ptr<Obj>>::value);
+        static_assert(!IsTriviallyRelocatable<Obj>::value);
+        static_assert(!IsTriviallyRelocatable<std::string>::value);
     }
-    C(C&& /*other*/) noexcept {
-        ++move_ctor;
+}
+
+void Test8() {
+    const size_t SIZE = 100;
+    {
+        std::pmr::monotonic_buffer_resource arena;
+        Vector<int, std::pmr::polymorphic_allocator<int>> v(&arena);
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.PushBack(static_cast<int>(i));
+        }
+        assert(v.Size() == SIZE);
+        assert(v.GetAllocator().resource() == &arena);
+
+        // polymorphic_allocator не распространяется: копия получает ресурс по умолчанию,
+        // а присваивание сохраняет собственный ресурс
+        Vector<int, std::pmr::polymorphic_allocator<int>> v_copy(v);
+        assert(v_copy.GetAllocator().resource() == std::pmr::get_default_resource());
+        std::pmr::monotonic_buffer_resource other_arena;
+        Vector<int, std::pmr::polymorphic_allocator<int>> v_other(&other_arena);
+        v_other = std::move(v);
+        assert(v_other.GetAllocator().resource() == &other_arena);
+        assert(v_other.Size() == SIZE);
+        assert(v_other[SIZE - 1] == static_cast<int>(SIZE - 1));
     }
-    C& operator=(const C& other) noexcept {
-        if (this != &other) {
-            ++copy_assign;
+    {
+        Obj::ResetCounters();
+        int arena_a = 0;
+        int arena_b = 0;
+        {
+            Vector<Obj, ArenaAllocator<Obj>> a(SIZE, ArenaAllocator<Obj>(&arena_a));
+            Vector<Obj, ArenaAllocator<Obj>> b{ArenaAllocator<Obj>(&arena_b)};
+            assert(arena_a == 1);
+            b.EmplaceBack(1);
+            assert(arena_b == 1);
+
+            b = a;
+            assert(b.GetAllocator() == a.GetAllocator());
+            assert(arena_a == 2);
+            assert(arena_b == 0);
+
+            Vector<Obj, ArenaAllocator<Obj>> c{ArenaAllocator<Obj>(&arena_b)};
+            c.EmplaceBack(2);
+            c.Swap(a);
+            assert(c.Size() == SIZE);
+            assert(a.Size() == 1);
+            assert(a.GetAllocator().live_allocations == &arena_b);
+
+            c = std::move(a);
+            assert(c.Size() == 1);
+            assert(c[0].id == 2);
+            assert(arena_a == 1);
+            assert(arena_b == 1);
         }
-        return *this;
+        assert(arena_a == 0);
+        assert(arena_b == 0);
+        assert(Obj::GetAliveObjectCount() == 0);
     }
-    C& operator=(C&& /*other*/) noexcept {
-        ++move_assign;
-        return *this;
+}
+
+void Test9() {
+    const size_t SIZE = 1000;
+    {
+        AlignedVector<float> v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.PushBack(static_cast<float>(i));
+            assert(reinterpret_cast<uintptr_t>(&v[0]) % CACHE_LINE_SIZE == 0);
+        }
+        assert(v[SIZE - 1] == static_cast<float>(SIZE - 1));
+    }
+    {
+        AlignedVector<double, 32> v(SIZE);
+        assert(reinterpret_cast<uintptr_t>(&v[0]) % 32 == 0);
+        AlignedVector<double, 32> v_copy(v);
+        assert(reinterpret_cast<uintptr_t>(&v_copy[0]) % 32 == 0);
+    }
+    {
+        struct alignas(128) Block {
+            char bytes[128];
+        };
+        Vector<Block> v(3);
+        assert(reinterpret_cast<uintptr_t>(&v[0]) % alignof(Block) == 0);
+        AlignedVector<Block, 16> v_aligned(3);
+        assert(reinterpret_cast<uintptr_t>(&v_aligned[0]) % alignof(Block) == 0);
     }
-    ~C() {
-        ++dtor;
+}
+
+void Test10() {
+    using namespace std::literals;
+    const size_t INLINE = 4;
+    const size_t SIZE = 20;
+    {
+        SmallVector<std::string, INLINE> v;
+        for (size_t i = 0; i < INLINE; ++i) {
+            v.PushBack(std::to_string(i));
+        }
+        assert(v.IsInline());
+        assert(v.Capacity() == INLINE);
+        v.Insert(v.cbegin() + 1, "x"s);
+        assert(!v.IsInline());
+        assert(v.Size() == INLINE + 1);
+        assert(v[0] == "0"s && v[1] == "x"s && v[INLINE] == std::to_string(INLINE - 1));
+        v.Erase(v.cbegin() + 1);
+        assert(v[1] == "1"s);
     }
+    {
+        Obj::ResetCounters();
+        {
+            SmallVector<Obj, INLINE> small;
+            SmallVector<Obj, INLINE> large;
+            small.EmplaceBack(1);
+            for (size_t i = 0; i < SIZE; ++i) {
+                large.EmplaceBack(static_cast<int>(i));
+            }
+            small.Swap(large);
+            assert(small.Size() == SIZE && !small.IsInline());
+            assert(large.Size() == 1 && large.IsInline());
+            assert(large[0].id == 1);
+            assert(small[SIZE - 1].id == static_cast<int>(SIZE - 1));
 
-    static void Reset() {
-        def_ctor = 0;
-        copy_ctor = 0;
-        move_ctor = 0;
-        copy_assign = 0;
-        move_assign = 0;
-        dtor = 0;
+            SmallVector<Obj, INLINE> other;
+            other.EmplaceBack(7);
+            other.EmplaceBack(8);
+            other.Swap(large);
+            assert(other.Size() == 1 && other[0].id == 1);
+            assert(large.Size() == 2 && large[1].id == 8);
+
+            SmallVector<Obj, INLINE> moved(std::move(large));
+            assert(moved.Size() == 2 && large.Size() == 0);
+            SmallVector<Obj, INLINE> copied(small);
+            assert(copied.Size() == SIZE && copied[3].id == 3);
+            copied = moved;
+            assert(copied.Size() == 2 && copied[0].id == 7);
+            moved = std::move(small);
+            assert(moved.Size() == SIZE);
+            assert(Obj::GetAliveObjectCount() == 1 + 2 + SIZE);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        SmallVector<TestObj, 1> v(1);
+        v.PushBack(v[0]);
+        v.Insert(v.cbegin() + 1, v[0]);
+        assert(std::all_of(v.begin(), v.end(), [](const TestObj& obj) {
+            return obj.IsAlive();
+        }));
     }
+    {
+        // Присваивание между разными ресурсами pmr сохраняет ресурс получателя
+        using PmrSmallVector = SmallVector<std::pmr::string, INLINE, std::pmr::polymorphic_allocator<std::pmr::string>>;
+        std::pmr::monotonic_buffer_resource arena;
+        std::pmr::monotonic_buffer_resource other_arena;
+        PmrSmallVector lhs(&arena);
+        PmrSmallVector rhs(&other_arena);
+        for (size_t i = 0; i < SIZE; ++i) {
+            rhs.PushBack(std::pmr::string(std::to_string(i)));
+        }
+        lhs = rhs;
+        assert(lhs.Size() == SIZE && lhs[SIZE - 1] == "19" && !lhs.IsInline());
+        assert(lhs.GetAllocator().resource() == &arena);
 
-    inline static size_t def_ctor = 0;
-    inline static size_t copy_ctor = 0;
-    inline static size_t move_ctor = 0;
-    inline static size_t copy_assign = 0;
-    inline static size_t move_assign = 0;
-    inline static size_t dtor = 0;
-};
+        PmrSmallVector small(&other_arena);
+        small.PushBack(std::pmr::string("a"));
+        lhs = small;
+        assert(lhs.Size() == 1 && lhs[0] == "a" && lhs.GetAllocator().resource() == &arena);
+
+        lhs = std::move(rhs);
+        assert(lhs.Size() == SIZE && lhs[3] == "3" && lhs.GetAllocator().resource() == &arena);
+        assert(rhs.GetAllocator().resource() == &other_arena);
+
+        PmrSmallVector same(&arena);
+        same = std::move(lhs);
+        assert(same.Size() == SIZE && lhs.Size() == 0);
+        small = std::move(same);
+        assert(small.Size() == SIZE && small.GetAllocator().resource() == &other_arena);
+    }
+}
 
-void Dump() {
-    using namespace std;
-    cerr << "Def ctors: "sv << C::def_ctor              //
-         << ", Copy ctors: "sv << C::copy_ctor          //
-         << ", Move ctors: "sv << C::move_ctor          //
-         << ", Copy assignments: "sv << C::copy_assign  //
-         << ", Move assignments: "sv << C::move_assign  //
-         << ", Dtors: "sv << C::dtor << endl;
+template <typename GrowthPolicy>
+size_t CountReallocations(size_t count) {
+    Vector<int, std::allocator<int>, GrowthPolicy> v;
+    size_t reallocations = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const size_t old_capacity = v.Capacity();
+        v.PushBack(static_cast<int>(i));
+        reallocations += v.Capacity() != old_capacity;
+    }
+    return reallocations;
 }
 
-void Benchmark() {
-    using namespace std;
-    try {
-        const size_t NUM = 10;
-        C c;
-        {
-            cerr << "std::vector:"sv << endl;
-            C::Reset();
-            vector<C> v(NUM);
-            Dump();
-            v.push_back(c);
+void Test11() {
+    const size_t SIZE = 10;
+    {
+        // Первое выделение занимает целую кэш-линию
+        Vector<int> v;
+        v.PushBack(1);
+        assert(v.Capacity() == CACHE_LINE_SIZE / sizeof(int));
+        assert(CountReallocations<DoublingGrowth>(SIZE) == 1);
+        assert(CountReallocations<GoldenGrowth>(SIZE) == 1);
+    }
+    {
+        Vector<int, std::allocator<int>, GoldenGrowth> v(SIZE * 10);
+        v.PushBack(0);
+        assert(v.Capacity() == SIZE * 10 + SIZE * 5 + 1);
+    }
+    {
+        assert(SizeClassGrowth::RoundUpToSizeClass(1) == 8);
+        assert(SizeClassGrowth::RoundUpToSizeClass(17) == 32);
+        assert(SizeClassGrowth::RoundUpToSizeClass(129) == 160);
+        assert(SizeClassGrowth::RoundUpToSizeClass(4097) == 5120);
+        // 3 * 12 * 2 = 72 байта округляются до класса 80, куда помещается 6 элементов
+        struct Triple {
+            int a, b, c;
+        };
+        Vector<Triple, std::allocator<Triple>, SizeClassGrowth> v(3);
+        v.PushBack(Triple{});
+        assert(v.Capacity() == 6);
+        Vector<Triple, std::allocator<Triple>, SizeClassGrowth> v_large(100);
+        v_large.PushBack(Triple{});
+        assert(v_large.Capacity() * sizeof(Triple) <= 2560);
+        assert(v_large.Capacity() == 2560 / sizeof(Triple));
+    }
+}
+
+void Test12() {
+    const size_t SIZE = 100'000;
+    static_assert(HasReallocate<MallocAllocator<int>>::value);
+    static_assert(!HasReallocate<std::allocator<int>>::value);
+    {
+        Vector<int, MallocAllocator<int>> v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.PushBack(static_cast<int>(i));
+        }
+        v.Reserve(SIZE * 4);
+        assert(v.Capacity() == SIZE * 4);
+        assert(v.Size() == SIZE);
+        for (size_t i = 0; i < SIZE; ++i) {
+            assert(v[i] == static_cast<int>(i));
         }
-        Dump();
-    } catch (...) {
+        Vector<int, MallocAllocator<int>> v_copy(v);
+        assert(v_copy[SIZE - 1] == static_cast<int>(SIZE - 1));
     }
-    try {
-        const size_t NUM = 10;
-        C c;
-        {
-            cerr << "Vector:"sv << endl;
-            C::Reset();
-            Vector<C> v(NUM);
-            Dump();
-            v.PushBack(c);
+    {
+        Vector<std::unique_ptr<int>, MallocAllocator<std::unique_ptr<int>>> v;
+        v.EmplaceBack(std::make_unique<int>(1));
+        while (v.Size() != v.Capacity()) {
+            v.EmplaceBack(std::make_unique<int>(3));
+        }
+        v.Emplace(v.cbegin() + 1, std::make_unique<int>(2));
+        assert(*v[0] == 1 && *v[1] == 2 && *v[2] == 3);
+    }
+    {
+        Vector<int, MallocAllocator<int>> v(1);
+        v[0] = 42;
+        assert(v.Size() == v.Capacity());
+        // Добавление собственного элемента должно быть безопасно при расширении буфера
+        v.PushBack(v[0]);
+        assert(v[1] == 42);
+    }
+}
+
+void Test13() {
+    const size_t SIZE = 1000;
+    {
+        Vector<char> v;
+        v.ResizeUninitialized(SIZE);
+        assert(v.Size() == SIZE);
+        std::fill(v.begin(), v.end(), 'a');
+        v.ResizeUninitialized(SIZE / 2);
+        assert(v.Size() == SIZE / 2);
+        assert(v.Capacity() == SIZE);
+        assert(v[SIZE / 2 - 1] == 'a');
+    }
+    {
+        Vector<int> v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            std::span<int> chunk = v.AppendUninitialized(3);
+            assert(chunk.size() == 3);
+            assert(chunk.data() == &v[v.Size() - 3]);
+            std::fill(chunk.begin(), chunk.end(), static_cast<int>(i));
+        }
+        assert(v.Size() == SIZE * 3);
+        assert(v[SIZE * 3 - 1] == static_cast<int>(SIZE - 1));
+        assert(v.Capacity() < SIZE * 6);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v;
+        v.ResizeDefaultInit(SIZE);
+        assert(Obj::num_default_constructed == SIZE);
+        v.AppendUninitialized(SIZE);
+        assert(v.Size() == SIZE * 2);
+        assert(Obj::num_default_constructed == SIZE * 2);
+        v.ResizeDefaultInit(1);
+        assert(Obj::GetAliveObjectCount() == 1);
+    }
+}
+
+void Test14() {
+    using namespace std::literals;
+    const size_t SIZE = 10;
+    {
+        std::vector<int> source{1, 2, 3, 4, 5};
+        Vector<int> v(source.begin(), source.end());
+        assert(v.Size() == source.size());
+        assert(v.Capacity() == source.size());
+        assert(std::equal(v.begin(), v.end(), source.begin()));
+
+        v.Insert(v.cbegin() + 1, source.begin(), source.end());
+        v.Append(source.begin(), source.begin() + 2);
+        const std::vector<int> expected{1, 1, 2, 3, 4, 5, 2, 3, 4, 5, 1, 2};
+        assert(std::equal(v.begin(), v.end(), expected.begin(), expected.end()));
+    }
+    {
+        std::istringstream input("1 2 3");
+        Vector<int> v(SIZE);
+        v.Insert(v.cbegin() + 1, std::istream_iterator<int>(input), std::istream_iterator<int>());
+        assert(v.Size() == SIZE + 3);
+        assert(v[0] == 0 && v[1] == 1 && v[2] == 2 && v[3] == 3 && v[4] == 0);
+
+        // Ошибка чтения посреди диапазона удаляет уже добавленные элементы
+        std::istringstream broken("4 5 6 x");
+        broken.exceptions(std::ios::failbit);
+        try {
+            v.Insert(v.cbegin(), std::istream_iterator<int>(broken), std::istream_iterator<int>());
+            assert(false);
+        } catch (const std::ios_base::failure&) {
+        }
+        assert(v.Size() == SIZE + 3 && v[0] == 0 && v[1] == 1 && v[SIZE + 2] == 0);
+    }
+    {
+        std::list<std::string> source{"a"s, "b"s, "c"s};
+        Vector<std::string> v;
+        v.PushBack("x"s);
+        v.PushBack("y"s);
+        v.Reserve(SIZE);
+        v.Insert(v.cbegin() + 1, source.begin(), source.end());
+        const std::vector<std::string> expected{"x"s, "a"s, "b"s, "c"s, "y"s};
+        assert(std::equal(v.begin(), v.end(), expected.begin(), expected.end()));
+        v.Insert(v.cbegin() + 4, source.begin(), std::next(source.begin()));
+        assert(v[4] == "a"s && v[5] == "y"s);
+    }
+    {
+        Obj::ResetCounters();
+        std::vector<Obj> source(3);
+        Vector<Obj> v(SIZE);
+        v.Reserve(SIZE * 2);
+        const int old_moved = Obj::num_moved;
+        v.Insert(v.cbegin() + 2, source.begin(), source.end());
+        assert(v.Size() == SIZE + 3);
+        assert(Obj::num_moved - old_moved == 3);
+        assert(Obj::num_move_assigned == SIZE - 2 - 3);
+        assert(Obj::num_assigned == 3);
+
+        // Вставка с перевыделением выполняет ровно одно выделение памяти
+        v.Insert(v.cbegin() + 1, SIZE * 2, v[0]);
+        assert(v.Size() == SIZE * 3 + 3);
+        assert(Obj::GetAliveObjectCount() == 3 + SIZE * 3 + 3);
+    }
+    {
+        Vector<TestObj> v(SIZE);
+        v.Reserve(SIZE * 4);
+        v.Insert(v.cbegin() + 1, SIZE * 2, v[SIZE - 1]);
+        v.Insert(v.cbegin() + 1, 2, v[SIZE]);
+        assert(v.Size() == SIZE * 3 + 2);
+        assert(std::all_of(v.begin(), v.end(), [](const TestObj& obj) {
+            return obj.IsAlive();
+        }));
+        Vector<int> ints(SIZE);
+        ints[SIZE - 1] = 7;
+        ints.Insert(ints.cbegin(), 3, ints[SIZE - 1]);
+        assert(ints[0] == 7 && ints[2] == 7 && ints[3] == 0 && ints[SIZE + 2] == 7);
+    }
+}
+
+void Test15() {
+    const size_t SIZE = 100;
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        for (size_t i = 0; i < SIZE; ++i) {
+            v[i].id = static_cast<int>(i);
+        }
+        auto* pos = v.Erase(v.cbegin() + 10, v.cbegin() + 20);
+        assert(pos == v.begin() + 10);
+        assert(pos->id == 20);
+        assert(v.Size() == SIZE - 10);
+        assert(Obj::num_move_assigned == SIZE - 20);
+        assert(Obj::GetAliveObjectCount() == SIZE - 10);
+        assert(v.Erase(v.cbegin(), v.cbegin()) == v.begin());
+
+        const size_t n_removed = v.EraseIf([](const Obj& obj) {
+            return obj.id % 2 != 0;
+        });
+        assert(n_removed == (SIZE - 10) / 2);
+        assert(v.Size() == (SIZE - 10) / 2);
+        assert(std::all_of(v.begin(), v.end(), [](const Obj& obj) {
+            return obj.id % 2 == 0;
+        }));
+        assert(Obj::GetAliveObjectCount() == (SIZE - 10) / 2);
+
+        const int last_id = v[v.Size() - 1].id;
+        pos = v.SwapErase(v.cbegin());
+        assert(pos->id == last_id);
+        assert(v.Size() == (SIZE - 10) / 2 - 1);
+        v.SwapErase(v.cend() - 1);
+        assert(v.Size() == (SIZE - 10) / 2 - 2);
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(v.Size()));
+    }
+}
+
+void Test16() {
+    using namespace std::literals;
+    const size_t SIZE = 10;
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        v.Reserve(SIZE * 2);
+        const int old_num_moved = Obj::num_moved;
+        // Перемещение элемента того же типа записывается сразу на место, без временного объекта
+        v.Insert(v.cbegin() + 3, Obj{1});
+        assert(v[3].id == 1);
+        assert(Obj::num_constructed_with_id == 1);
+        assert(Obj::num_moved == old_num_moved + 1);
+        assert(Obj::num_move_assigned == SIZE - 3);
+        assert(Obj::GetAliveObjectCount() == SIZE + 1);
+    }
+    {
+        Vector<int> v(SIZE);
+        v.Reserve(SIZE * 2);
+        for (size_t i = 0; i < SIZE; ++i) {
+            v[i] = static_cast<int>(i);
+        }
+        v.Insert(v.cbegin() + 1, v[5]);
+        assert(v[1] == 5 && v[6] == 5 && v[2] == 1);
+        v.Insert(v.cbegin() + 1, v[v.Size() - 1]);
+        assert(v[1] == static_cast<int>(SIZE - 1));
+        v.Insert(v.cbegin() + 2, v[0]);
+        assert(v[2] == 0);
+    }
+    {
+        Vector<std::string> v;
+        v.Reserve(SIZE);
+        v.PushBack("a"s);
+        v.PushBack("b"s);
+        v.PushBack("c"s);
+        v.Insert(v.cbegin(), v[2]);
+        v.Insert(v.cbegin() + 1, std::move(v[3]));
+        const std::vector<std::string> expected{"c"s, "c"s, "a"s, "b"s, ""s};
+        assert(std::equal(v.begin(), v.end(), expected.begin(), expected.end()));
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        v.Reserve(SIZE * 2);
+        v[5].id = 5;
+        Obj::default_construction_throw_countdown = 1;
+        try {
+            v.Emplace(v.cbegin() + 1);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == SIZE);
+        assert(v[5].id == 5);
+        assert(Obj::num_move_assigned == 0);
+        assert(Obj::GetAliveObjectCount() == SIZE);
+    }
+}
+
+void Test17() {
+    const size_t SIZE = 100;
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        v.Reserve(SIZE * 4);
+        v.Resize(SIZE / 2);
+        v.ShrinkToFit();
+        assert(v.Size() == SIZE / 2);
+        assert(v.Capacity() == SIZE / 2);
+        assert(Obj::GetAliveObjectCount() == SIZE / 2);
+
+        v.Clear();
+        assert(v.Size() == 0);
+        assert(v.Capacity() == SIZE / 2);
+        assert(Obj::GetAliveObjectCount() == 0);
+
+        v.Resize(SIZE / 4);
+        v.ReleaseMemory();
+        assert(v.Size() == 0);
+        assert(v.Capacity() == 0);
+        assert(Obj::GetAliveObjectCount() == 0);
+        v.ShrinkToFit();
+        v.PushBack(Obj{1});
+        assert(v[0].id == 1);
+    }
+    {
+        Vector<int, MallocAllocator<int>> v(SIZE);
+        v[SIZE / 4 - 1] = 42;
+        v.Resize(SIZE / 4);
+        v.ShrinkToFit();
+        assert(v.Capacity() == SIZE / 4);
+        assert(v[SIZE / 4 - 1] == 42);
+        v.Clear();
+        v.ShrinkToFit();
+        assert(v.Capacity() == 0);
+    }
+    {
+        // Ёмкость округляется до класса размеров: 25 * 4 = 100 байт занимают блок из 112 байт
+        Vector<int, std::allocator<int>, SizeClassGrowth> v(SIZE);
+        v.Resize(SIZE / 4);
+        v.ShrinkToFit();
+        assert(v.Capacity() == 112 / sizeof(int));
+    }
+}
+
+void Test18() {
+    const size_t SIZE = 10;
+    static_assert(sizeof(Vector<int>) == sizeof(int*) + 2 * sizeof(size_t));
+    VectorStatsRegistry::Instance().Reset();
+    {
+        CountedVector<Obj> v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.EmplaceBack(static_cast<int>(i));
+        }
+        v.Reserve(SIZE * 4);
+    }
+    {
+        CountedVector<int> v(SIZE);
+        v.PushBack(1);
+    }
+    const VectorCounters& obj_counters = CountingStats::Counters<Obj>();
+    // Ёмкость Obj растёт 1 -> 2 -> 4 -> 8 -> 16, затем Reserve до 40
+    assert(obj_counters.allocations == 6);
+    assert(obj_counters.deallocations == 6);
+    assert(obj_counters.reallocations == 5);
+    assert(obj_counters.elements_moved == 1 + 2 + 4 + 8 + SIZE);
+    assert(obj_counters.elements_copied == 0);
+    assert(obj_counters.peak_capacity == SIZE * 4);
+    assert(obj_counters.released_size == SIZE);
+    assert(obj_counters.released_capacity == SIZE * 4);
+
+    const VectorCounters& int_counters = CountingStats::Counters<int>();
+    assert(int_counters.allocations == 2);
+    assert(int_counters.elements_relocated == SIZE);
+    assert(int_counters.elements_moved == 0);
+
+    std::ostringstream out;
+    VectorStatsRegistry::Instance().Dump(out);
+    assert(out.str().find("Obj: allocations 6") != std::string::npos);
+    assert(out.str().find("int: allocations 2") != std::string::npos);
+}
+
+void Test19() {
+    using namespace std::literals;
+    const size_t SIZE = 100;
+    {
+        SoAVector<int, double, std::string> v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.EmplaceBack(static_cast<int>(i), i * 0.5, std::to_string(i));
+        }
+        assert(v.Size() == SIZE);
+        assert(v.Capacity() >= SIZE);
+
+        std::span<const int> ids = std::as_const(v).Column<0>();
+        assert(ids.size() == SIZE);
+        assert(&ids[1] - &ids[0] == 1);
+        assert(std::accumulate(ids.begin(), ids.end(), 0) == static_cast<int>(SIZE * (SIZE - 1) / 2));
+
+        auto [id, price, name] = v[10];
+        assert(id == 10 && price == 5.0 && name == "10"s);
+        price = 42.0;
+        assert(v.Get<1>(10) == 42.0);
+
+        size_t rows = 0;
+        for (auto [row_id, row_price, row_name] : v) {
+            assert(row_name == std::to_string(row_id));
+            ++rows;
+        }
+        assert(rows == SIZE);
+        auto it = std::find_if(v.cbegin(), v.cend(), [](const auto& row) {
+            return std::get<2>(row) == "50"s;
+        });
+        assert(it - v.cbegin() == 50);
+
+        SoAVector<int, double, std::string> v_copy(v);
+        v.PopBack();
+        assert(v.Size() == SIZE - 1);
+        assert(v_copy.Size() == SIZE);
+        assert(std::get<2>(v_copy[SIZE - 1]) == std::to_string(SIZE - 1));
+        v = std::move(v_copy);
+        assert(v.Size() == SIZE);
+        v.Resize(SIZE / 2);
+        assert(v.Size() == SIZE / 2);
+        v.Resize(SIZE);
+        assert(std::get<2>(v[SIZE - 1]).empty());
+    }
+    {
+        // Аргументы могут ссылаться на поля самого вектора, даже если добавление перевыделяет столбцы
+        SoAVector<int, std::string> v;
+        v.EmplaceBack(1, std::string(100, 'a'));
+        while (v.Size() != v.Capacity()) {
+            v.EmplaceBack(v.Get<0>(0), v.Get<1>(0));
+        }
+        const size_t size = v.Size();
+        v.EmplaceBack(v.Get<0>(0), v.Get<1>(0));
+        assert(v.Size() == size + 1 && v.Capacity() > size);
+        assert(v.Get<0>(size) == 1 && v.Get<1>(size) == std::string(100, 'a'));
+        assert(v.Get<1>(0) == std::string(100, 'a'));
+    }
+    {
+        Obj::ResetCounters();
+        {
+            SoAVector<Obj, Obj> v;
+            v.EmplaceBack(Obj{1}, Obj{2});
+            Obj::default_construction_throw_countdown = 2;
+            try {
+                v.EmplaceBack(Obj{}, Obj{});
+                assert(false && "Exception is expected");
+            } catch (const std::runtime_error&) {
+            }
+            assert(v.Size() == 1);
+            assert(Obj::GetAliveObjectCount() == 2);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        // Исключение конструктора поля не оставляет созданных строк
+        Obj::ResetCounters();
+        Obj::default_construction_throw_countdown = 7;
+        try {
+            SoAVector<int, Obj> v(10);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+
+        SoAVector<Obj, Obj> v;
+        for (int i = 0; i != 5; ++i) {
+            v.EmplaceBack(Obj{i}, Obj{-i});
+        }
+        std::get<1>(v[3]).throw_on_copy = true;
+        try {
+            SoAVector<Obj, Obj> v_copy(v);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(Obj::GetAliveObjectCount() == 10);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+void Test20() {
+    const size_t SIZE = 1000;
+    ParallelOptions options;
+    options.num_threads = 4;
+    options.min_elements_per_thread = 16;
+    assert(options.ChunkCount(SIZE) == 4);
+    assert(options.ChunkCount(20) == 1);
+    {
+        Vector<AtomicObj> v(SIZE, options);
+        assert(v.Size() == SIZE);
+        assert(AtomicObj::num_alive == static_cast<int>(SIZE));
+        for (size_t i = 0; i < SIZE; ++i) {
+            v[i].id = static_cast<int>(i);
+        }
+
+        Vector<AtomicObj> copy(v, options);
+        assert(copy.Size() == SIZE);
+        assert(AtomicObj::num_alive == static_cast<int>(2 * SIZE));
+        for (size_t i = 0; i < SIZE; ++i) {
+            assert(copy[i].id == static_cast<int>(i));
+        }
+
+        copy.ParallelResize(SIZE / 2, options);
+        assert(copy.Size() == SIZE / 2);
+        copy.ParallelResize(SIZE * 2, options);
+        assert(copy.Size() == SIZE * 2);
+        assert(copy[SIZE / 2 - 1].id == static_cast<int>(SIZE / 2 - 1));
+        assert(copy[SIZE].id == 0);
+        assert(AtomicObj::num_alive == static_cast<int>(3 * SIZE));
+
+        const AtomicObj* buffer = copy.begin();
+        copy.ParallelAssign(v, options);
+        assert(copy.Size() == SIZE);
+        assert(copy.begin() == buffer);
+        assert(copy[SIZE - 1].id == static_cast<int>(SIZE - 1));
+
+        copy.ParallelClear(options);
+        assert(copy.Size() == 0);
+        assert(AtomicObj::num_alive == static_cast<int>(SIZE));
+    }
+    assert(AtomicObj::num_alive == 0);
+    {
+        // Исключение в одной из частей: созданные другими потоками элементы разрушаются
+        Vector<AtomicObj> v(SIZE, options);
+        v[SIZE - 10].throw_on_copy = true;
+        try {
+            Vector<AtomicObj> copy(v, options);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(AtomicObj::num_alive == static_cast<int>(SIZE));
+
+        Vector<AtomicObj> target(SIZE / 2, options);
+        try {
+            target.ParallelAssign(v, options);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(target.Size() == 0);
+        assert(AtomicObj::num_alive == static_cast<int>(SIZE));
+    }
+    assert(AtomicObj::num_alive == 0);
+    {
+        // Аллокатор переходит к получателю, хотя при перемещении не распространяется
+        int live = 0;
+        int other_live = 0;
+        using ArenaVector = Vector<int, CopyPropagatingArenaAllocator<int>>;
+        ArenaVector v(SIZE, options, CopyPropagatingArenaAllocator<int>(&live));
+        std::iota(v.begin(), v.end(), 0);
+        ArenaVector target(SIZE / 2, options, CopyPropagatingArenaAllocator<int>(&other_live));
+        target.ParallelAssign(v, options);
+        assert(target.GetAllocator() == v.GetAllocator());
+        assert(live == 2 && other_live == 0);
+        assert(std::equal(v.begin(), v.end(), target.begin(), target.end()));
+
+        ArenaVector copy(SIZE / 2, options, CopyPropagatingArenaAllocator<int>(&other_live));
+        copy = v;
+        assert(copy.GetAllocator() == v.GetAllocator());
+        assert(live == 3 && other_live == 0);
+        assert(std::equal(v.begin(), v.end(), copy.begin(), copy.end()));
+    }
+    {
+        Vector<int> v(SIZE * 10, ParallelOptions{});
+        assert(std::all_of(v.begin(), v.end(), [](int value) {
+            return value == 0;
+        }));
+        std::iota(v.begin(), v.end(), 0);
+        Vector<int> copy(v, options);
+        assert(std::equal(v.begin(), v.end(), copy.begin(), copy.end()));
+    }
+}
+
+template <typename T>
+void CheckBulkAlgorithms() {
+    // Размеры охватывают пустой диапазон, неполный блок и хвосты после целых блоков
+    for (size_t size : {0, 1, 7, 63, 64, 65, 200, 1000, 5000}) {
+        Vector<T> v(size);
+        for (size_t i = 0; i < size; ++i) {
+            v[i] = static_cast<T>((i * 37 + 11) % 101);
+        }
+        std::vector<T> expected(v.begin(), v.end());
+
+        for (T value : {T(0), T(11), T(100), T(55)}) {
+            assert(Find(v, value) - v.begin() == std::find(expected.begin(), expected.end(), value) - expected.begin());
+            assert(Count(v, value) == static_cast<size_t>(std::count(expected.begin(), expected.end(), value)));
+        }
+        if (size != 0) {
+            auto [min, max] = MinMax(v);
+            assert(min == *std::min_element(expected.begin(), expected.end()));
+            assert(max == *std::max_element(expected.begin(), expected.end()));
+        }
+        double expected_sum = std::accumulate(expected.begin(), expected.end(), 0.0);
+        assert(static_cast<double>(Sum(v)) == expected_sum);
+
+        Vector<T> copy(v);
+        assert(Equal(v, copy) && v == copy);
+        assert(LexicographicCompare(v, copy) == 0);
+        if (size != 0) {
+            copy[size - 1] = static_cast<T>(copy[size - 1] + 1);
+            assert(!Equal(v, copy) && !(v == copy));
+            assert(LexicographicCompare(v, copy) < 0);
+            assert(LexicographicCompare(copy, v) > 0);
+            copy.PopBack();
+            assert(LexicographicCompare(copy, v) < 0);
+        }
+
+        Fill(v, T(3));
+        assert(Count(v, T(3)) == size);
+        std::span<const T> view(v.begin(), size);
+        assert(Find(view, T(4)) == view.end());
+    }
+}
+
+void Test21() {
+    CheckBulkAlgorithms<int8_t>();
+    CheckBulkAlgorithms<uint8_t>();
+    CheckBulkAlgorithms<int16_t>();
+    CheckBulkAlgorithms<int32_t>();
+    CheckBulkAlgorithms<uint32_t>();
+    CheckBulkAlgorithms<int64_t>();
+    CheckBulkAlgorithms<float>();
+    CheckBulkAlgorithms<double>();
+    {
+        // Узкие целые не переполняются при подсчёте и суммировании
+        Vector<uint8_t> bytes(100000);
+        Fill(bytes, uint8_t{255});
+        assert(Count(bytes, uint8_t{255}) == bytes.Size());
+        assert(Sum(bytes) == 255u * bytes.Size());
+    }
+    {
+        // Числа с плавающей точкой сравниваются по значению, а не по байтам
+        Vector<float> lhs(100);
+        Vector<float> rhs(100);
+        rhs[99] = -0.0f;
+        assert(Equal(lhs, rhs) && lhs == rhs);
+        rhs[50] = std::numeric_limits<float>::quiet_NaN();
+        assert(!Equal(rhs, rhs));
+        assert(LexicographicCompare(lhs, rhs) == std::partial_ordering::unordered);
+    }
+    {
+        Vector<std::string> lhs;
+        lhs.PushBack("a");
+        Vector<std::string> rhs(lhs);
+        assert(lhs == rhs);
+        rhs[0] += "b";
+        assert(lhs != rhs);
+    }
+    {
+        // Пользовательский operator== сравнивает не все байты элемента
+        struct Key {
+            int id;
+            int cached_hash;
+
+            bool operator==(const Key& other) const {
+                return id == other.id;
+            }
+        };
+        static_assert(std::has_unique_object_representations_v<Key>);
+        Vector<Key> lhs;
+        lhs.PushBack({1, 10});
+        lhs.PushBack({2, 20});
+        Vector<Key> rhs;
+        rhs.PushBack({1, 0});
+        rhs.PushBack({2, 0});
+        assert(lhs == rhs);
+        rhs[1].id = 3;
+        assert(lhs != rhs);
+    }
+}
+
+void Test22() {
+    const int NUM_THREADS = 4;
+    const int PER_THREAD = 20000;
+    {
+        ConcurrentVector<std::pair<int, int>> v;
+        v.EmplaceBack(-1, -1);
+        const std::pair<int, int>* first = &v[0];
+
+        std::atomic<bool> done = false;
+        // Читатель проверяет опубликованные элементы, пока писатели добавляют новые
+        std::thread reader([&] {
+            size_t checked = 0;
+            while (!done.load() || checked < v.Size()) {
+                for (size_t size = v.Size(); checked < size; ++checked) {
+                    auto [thread, i] = v[checked];
+                    assert(thread == -1 || (thread >= 0 && thread < NUM_THREADS && i >= 0 && i < PER_THREAD));
+                }
+            }
+        });
+        std::vector<std::thread> writers;
+        for (int thread = 0; thread < NUM_THREADS; ++thread) {
+            writers.emplace_back([&v, thread] {
+                for (int i = 0; i < PER_THREAD; ++i) {
+                    auto& element = v.EmplaceBack(thread, i);
+                    assert(element.first == thread && element.second == i);
+                }
+            });
+        }
+        for (std::thread& writer : writers) {
+            writer.join();
+        }
+        done = true;
+        reader.join();
+
+        const size_t total = NUM_THREADS * PER_THREAD + 1;
+        assert(v.Size() == total && v.ClaimedSize() == total);
+        assert(v.Capacity() >= total);
+        assert(&v[0] == first);
+        // Элементы каждого потока идут в порядке их добавления
+        std::vector<int> next(NUM_THREADS, 0);
+        for (size_t i = 1; i < total; ++i) {
+            auto [thread, value] = v[i];
+            assert(value == next[thread]);
+            ++next[thread];
+        }
+        assert(std::all_of(next.begin(), next.end(), [](int count) {
+            return count == PER_THREAD;
+        }));
+    }
+    {
+        Obj::ResetCounters();
+        ConcurrentVector<Obj> v;
+        v.Reserve(1000);
+        assert(v.Capacity() >= 1000);
+        v.EmplaceBack(1);
+        Obj::default_construction_throw_countdown = 1;
+        try {
+            v.EmplaceBack();
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        // Пустая ячейка задерживает публикацию следующих элементов, но не теряет их
+        Obj& last = v.EmplaceBack(3);
+        assert(v.Size() == 1 && v.ClaimedSize() == 3);
+        assert(!v.IsPublished(1) && v.IsPublished(2));
+        assert(last.id == 3 && &v[2] == &last);
+        assert(Obj::GetAliveObjectCount() == 2);
+        v.Clear();
+        assert(v.Size() == 0 && Obj::GetAliveObjectCount() == 0);
+        v.EmplaceBack(4);
+        assert(v.Size() == 1 && v[0].id == 4);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+void Test23() {
+    {
+        // Сегменты по 4 элемента, чтобы границы сегментов встречались часто
+        SegmentedVector<int, 2> v;
+        assert(v.SEGMENT_SIZE == 4);
+        v.PushBack(0);
+        const int* first = &v[0];
+        for (int i = 1; i < 100; ++i) {
+            v.PushBack(i);
+        }
+        assert(&v[0] == first);
+        assert(v.Size() == 100 && v.Capacity() == 100);
+        assert(std::accumulate(v.begin(), v.end(), 0) == 99 * 100 / 2);
+        assert(std::is_sorted(v.cbegin(), v.cend()));
+        assert(v.end() - v.begin() == 100 && v.begin()[42] == 42);
+
+        v.Insert(v.cbegin() + 3, -1);
+        assert(v.Size() == 101 && v[3] == -1 && v[4] == 3 && v[100] == 99);
+        v.Erase(v.cbegin() + 3);
+        assert(v.Size() == 100 && v[3] == 3);
+
+        SegmentedVector<int, 2> copy(v);
+        assert(std::equal(v.begin(), v.end(), copy.begin(), copy.end()));
+        v.Resize(10);
+        assert(v.Size() == 10 && v.Capacity() == 104);
+        v.ShrinkToFit();
+        assert(v.Capacity() == 12);
+        v.Resize(13);
+        assert(v[12] == 0 && v.Capacity() == 16);
+        v.Reserve(33);
+        assert(v.Capacity() == 36);
+
+        v = std::move(copy);
+        assert(v.Size() == 100 && copy.Size() == 0);
+        v.ReleaseMemory();
+        assert(v.Size() == 0 && v.Capacity() == 0);
+    }
+    {
+        Obj::ResetCounters();
+        SegmentedVector<Obj, 3> v;
+        for (int i = 0; i < 20; ++i) {
+            v.EmplaceBack(i);
+        }
+        // Рост не перемещает элементы
+        assert(Obj::num_moved == 0 && Obj::num_copied == 0);
+        Obj::default_construction_throw_countdown = 1;
+        try {
+            v.EmplaceBack();
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == 20 && Obj::GetAliveObjectCount() == 20);
+        v.Clear();
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        int live_allocations = 0;
+        SegmentedVector<std::string, 1, ArenaAllocator<std::string>> v{ArenaAllocator<std::string>(&live_allocations)};
+        v.Resize(5);
+        assert(live_allocations == 4);
+        v.ReleaseMemory();
+        assert(live_allocations == 0);
+    }
+}
+
+void Test24() {
+    struct Point {
+        int x;
+        double y;
+    };
+    const std::string path = (std::filesystem::temp_directory_path() / "cppvector_test24.bin").string();
+    std::filesystem::remove(path);
+    const size_t SIZE = 1000;
+    {
+        MappedVector<Point> v(path);
+        assert(v.Size() == 0 && v.Capacity() == 0);
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.PushBack({static_cast<int>(i), i * 0.5});
+        }
+        assert(v.Size() == SIZE && v.Capacity() >= SIZE);
+        v.Flush();
+    }
+    {
+        MappedVector<Point> v(path);
+        assert(v.Size() == SIZE);
+        for (size_t i = 0; i < SIZE; ++i) {
+            assert(v[i].x == static_cast<int>(i) && v[i].y == i * 0.5);
+        }
+        v.PopBack();
+        v.Resize(SIZE + 10);
+        assert(v[SIZE - 1].x == 0 && v[SIZE + 9].x == 0);
+        v.Resize(SIZE);
+        v[SIZE - 1] = {-1, -1.0};
+        MappedVector<Point> moved(std::move(v));
+        assert(moved.Size() == SIZE && moved.Span().back().x == -1);
+    }
+    {
+        // Частное отображение не меняет файл даже при росте
+        MappedVector<Point> v(path, MapMode::PRIVATE);
+        assert(v.Size() == SIZE && v[SIZE - 1].x == -1);
+        v[0].x = 42;
+        for (size_t i = 0; i < SIZE * 4; ++i) {
+            v.EmplaceBack(Point{1, 1.0});
+        }
+        assert(v.Size() == SIZE * 5 && v[0].x == 42);
+    }
+    {
+        MappedVector<Point> v(path);
+        assert(v.Size() == SIZE && v[0].x == 0);
+    }
+    try {
+        MappedVector<int> wrong_type(path);
+        assert(false);
+    } catch (const std::runtime_error&) {
+    }
+    {
+        // Ёмкость, при которой размер данных переполняет size_t, распознаётся как испорченный заголовок
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        const uint64_t huge_capacity = uint64_t{1} << 60;
+        file.seekp(3 * sizeof(uint64_t));
+        file.write(reinterpret_cast<const char*>(&huge_capacity), sizeof(huge_capacity));
+    }
+    try {
+        MappedVector<Point> corrupted(path, MapMode::PRIVATE);
+        assert(false);
+    } catch (const std::runtime_error&) {
+    }
+    std::filesystem::remove(path);
+    try {
+        MappedVector<int> missing(path, MapMode::PRIVATE);
+        assert(false);
+    } catch (const std::system_error&) {
+    }
+}
+
+void Test25() {
+    {
+        Vector<int> v;
+        for (int i = 0; i < 10; ++i) {
+            v.PushBack(i);
+        }
+        assert(v.Data() == v.begin() && v.Span().size() == 10 && v.Span()[9] == 9);
+
+        const int* data = v.Data();
+        ReleasedBuffer<int> released = v.Release();
+        assert(released.data == data && released.size == 10 && released.capacity >= 10);
+        assert(v.Size() == 0 && v.Capacity() == 0 && v.Data() == nullptr);
+
+        Vector<int> adopted = Vector<int>::Adopt(released.data, released.size, released.capacity);
+        assert(adopted.Data() == data && adopted.Size() == 10 && adopted.Capacity() == released.capacity);
+        adopted.PushBack(10);
+        assert(adopted[10] == 10);
+    }
+    {
+        // Буфер снаружи: например, полученный из сети в память того же аллокатора
+        Obj::ResetCounters();
+        std::allocator<Obj> alloc;
+        Obj* buffer = alloc.allocate(4);
+        new (buffer) Obj(1);
+        new (buffer + 1) Obj(2);
+        {
+            auto v = Vector<Obj>::Adopt(buffer, 2, 4);
+            v.EmplaceBack(3);
+            assert(v.Data() == buffer && v.Size() == 3 && v[1].id == 2);
+            assert(Obj::num_moved == 0);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        CountedVector<int> v(5);
+        VectorCounters& counters = CountingStats::Counters<int>();
+        const size_t allocations = counters.allocations;
+        const size_t deallocations = counters.deallocations;
+        ReleasedBuffer<int> released = v.Release();
+        auto adopted = CountedVector<int>::Adopt(released.data, released.size, released.capacity);
+        assert(counters.allocations == allocations + 1 && counters.deallocations == deallocations + 1);
+    }
+    {
+        Vector<uint64_t> v;
+        for (uint64_t i = 0; i < 1000; ++i) {
+            v.PushBack(i * i);
+        }
+        std::stringstream stream;
+        Serialize(stream, v);
+        Serialize(stream, Vector<uint64_t>());
+        assert(stream.str().size() == 2 * 3 * sizeof(uint64_t) + v.Size() * sizeof(uint64_t));
+
+        auto restored = Deserialize<Vector<uint64_t>>(stream);
+        assert(restored == v && restored.Capacity() == v.Size());
+        assert(Deserialize<Vector<uint64_t>>(stream).Size() == 0);
+        try {
+            Deserialize<Vector<uint64_t>>(stream);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+
+        std::stringstream wrong_type;
+        Serialize(wrong_type, v);
+        try {
+            Deserialize<Vector<uint32_t>>(wrong_type);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+
+        std::string bytes;
+        {
+            std::stringstream out;
+            Serialize(out, v);
+            bytes = out.str();
+        }
+        std::stringstream truncated(bytes.substr(0, bytes.size() - 1));
+        try {
+            Deserialize<Vector<uint64_t>>(truncated);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+
+        // Испорченный размер в заголовке не приводит к огромному выделению памяти
+        std::string corrupted = bytes;
+        const uint64_t huge_size = uint64_t{1} << 40;
+        std::memcpy(corrupted.data() + 2 * sizeof(uint64_t), &huge_size, sizeof(huge_size));
+        std::stringstream corrupted_stream(corrupted);
+        try {
+            Deserialize<Vector<uint64_t>>(corrupted_stream);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+
+        // Поток без позиционирования читается порциями
+        struct SequentialBuffer : std::streambuf {
+            explicit SequentialBuffer(std::string& data) {
+                setg(data.data(), data.data(), data.data() + data.size());
+            }
+        };
+        SequentialBuffer sequential(bytes);
+        std::istream sequential_stream(&sequential);
+        assert(Deserialize<Vector<uint64_t>>(sequential_stream) == v);
+
+        SequentialBuffer sequential_corrupted(corrupted);
+        std::istream sequential_corrupted_stream(&sequential_corrupted);
+        try {
+            Deserialize<Vector<uint64_t>>(sequential_corrupted_stream);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+    }
+}
+
+void Test26() {
+    {
+        CowVector<std::string> v;
+        assert(v.Size() == 0 && v.UseCount() == 0);
+        for (int i = 0; i < 10; ++i) {
+            v.PushBack(std::to_string(i));
+        }
+        const CowVector<std::string> snapshot = v;
+        assert(v.UseCount() == 2 && snapshot.UseCount() == 2);
+        assert(snapshot.cbegin() == v.cbegin() && snapshot == v);
+
+        // Чтение не отделяет копии
+        assert(std::as_const(v)[3] == "3" && v.UseCount() == 2);
+
+        v[3] = "three";
+        assert(v.UseCount() == 1 && snapshot.UseCount() == 1);
+        assert(snapshot[3] == "3" && v[3] == "three");
+        assert(!(snapshot == v));
+
+        // Единолично владеющий вектор изменяется на месте
+        const std::string* data = v.cbegin();
+        v[4] = "four";
+        assert(v.cbegin() == data);
+
+        CowVector<std::string> copy = snapshot;
+        copy.EmplaceBack(copy[0]);
+        assert(copy.Size() == 11 && copy[10] == "0" && snapshot.Size() == 10);
+        copy.Insert(copy.cbegin(), std::as_const(copy)[9]);
+        assert(copy[0] == "9" && copy.Size() == 12);
+        copy.Erase(copy.cbegin());
+        assert(copy[0] == "0");
+
+        CowVector<std::string> cleared = snapshot;
+        cleared.Clear();
+        assert(cleared.Size() == 0 && snapshot.Size() == 10 && snapshot.UseCount() == 1);
+    }
+    {
+        Obj::ResetCounters();
+        {
+            CowVector<Obj> v(3);
+            CowVector<Obj> copies[4] = {v, v, v, v};
+            assert(v.UseCount() == 5 && Obj::GetAliveObjectCount() == 3);
+            copies[0].PopBack();
+            assert(copies[0].Size() == 2 && v.Size() == 3 && v.UseCount() == 4);
+            assert(Obj::GetAliveObjectCount() == 5);
+
+            // Исключение при копировании оставляет вектор разделённым
+            Obj::ResetCounters();
+            v[0].throw_on_copy = true;
+            {
+                CowVector<Obj> throwing = v;
+                try {
+                    throwing[1];
+                    assert(false);
+                } catch (const std::runtime_error&) {
+                }
+                assert(throwing.UseCount() == 2);
+            }
+            v[0].throw_on_copy = false;
+        }
+    }
+    {
+        // Снимки читаются потоками, пока владелец изменяет свою копию
+        CowVector<int> table(1000);
+        std::vector<std::thread> readers;
+        for (int i = 0; i < 4; ++i) {
+            readers.emplace_back([snapshot = table] {
+                long long sum = 0;
+                for (int round = 0; round < 100; ++round) {
+                    for (int value : snapshot.Span()) {
+                        sum += value;
+                    }
+                }
+                assert(sum == 0);
+            });
+        }
+        for (int i = 0; i < 1000; ++i) {
+            table[i] = i;
+        }
+        for (std::thread& reader : readers) {
+            reader.join();
+        }
+        assert(table.UseCount() == 1 && table[999] == 999);
+    }
+}
+
+void Test27() {
+    {
+        const size_t N = 40000;  // три уровня дерева
+        PersistentVector<int> v;
+        std::vector<PersistentVector<int>> versions;
+        for (size_t i = 0; i < N; ++i) {
+            v = v.PushBack(static_cast<int>(i));
+            if (i % 1000 == 0) {
+                versions.push_back(v);
+            }
+        }
+        assert(v.Size() == N);
+        for (size_t i = 0; i < N; ++i) {
+            assert(v[i] == static_cast<int>(i));
+        }
+        // Старые версии не меняются
+        for (size_t k = 0; k < versions.size(); ++k) {
+            assert(versions[k].Size() == k * 1000 + 1 && versions[k][k * 1000] == static_cast<int>(k * 1000));
+        }
+
+        const PersistentVector<int> changed = v.Set(12345, -1).Set(N - 1, -2);
+        assert(changed[12345] == -1 && changed[N - 1] == -2 && changed[12344] == 12344);
+        assert(v[12345] == 12345 && v[N - 1] == static_cast<int>(N - 1));
+
+        PersistentVector<int> popped = v;
+        while (popped.Size() > 0) {
+            assert(popped[popped.Size() - 1] == static_cast<int>(popped.Size() - 1));
+            popped = popped.PopBack();
+        }
+        assert(v.Size() == N && v[N - 1] == static_cast<int>(N - 1));
+
+        int expected = 0;
+        for (int value : v) {
+            assert(value == expected++);
+        }
+        assert(v.end() - v.begin() == static_cast<std::ptrdiff_t>(N) && v.begin()[777] == 777);
+    }
+    {
+        // Пакетные правки и преобразования из Vector и в Vector
+        Vector<std::string> source;
+        for (int i = 0; i < 1000; ++i) {
+            source.PushBack(std::to_string(i));
+        }
+        const PersistentVector<std::string> base(source);
+        assert(base.Size() == 1000 && base[999] == "999");
+
+        PersistentVector<std::string>::Transient batch = base.MakeTransient();
+        for (int i = 0; i < 1000; i += 2) {
+            batch.Set(i, "even");
+        }
+        for (int i = 0; i < 100; ++i) {
+            batch.PopBack();
+        }
+        batch.PushBack("tail");
+        const PersistentVector<std::string> edited = std::move(batch).Persistent();
+        assert(edited.Size() == 901 && edited[0] == "even" && edited[1] == "1" && edited[900] == "tail");
+        assert(base[0] == "0" && base.Size() == 1000);
+
+        const Vector<std::string> flat = edited.ToVector();
+        assert(flat.Size() == 901 && std::equal(flat.begin(), flat.end(), edited.begin()));
+        assert(base.ToVector() == source);
+    }
+    {
+        // Элементы разрушаются ровно один раз, когда их не держит ни одна версия
+        Obj::ResetCounters();
+        {
+            PersistentVector<Obj> v;
+            for (int i = 0; i < 100; ++i) {
+                v = v.PushBack(Obj(i));
+            }
+            const PersistentVector<Obj> snapshot = v;
+            v = v.Set(50, Obj(-1)).PopBack().PopBack();
+            assert(snapshot[50].id == 50 && v[50].id == -1 && v.Size() == 98);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+
+        // При исключении в копировании вектор и его версии не меняются
+        PersistentVector<Obj> v;
+        for (int i = 0; i < 40; ++i) {
+            v = v.PushBack(Obj(i));
+        }
+        Obj throwing(99);
+        throwing.throw_on_copy = true;
+        try {
+            v = v.PushBack(throwing);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == 40 && v[39].id == 39);
+
+        // Узлы, построенные до исключения, освобождаются вместе с элементами
+        Vector<Obj> source(100);
+        source[70].throw_on_copy = true;
+        const int alive = Obj::GetAliveObjectCount();
+        try {
+            PersistentVector<Obj> built(source);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(Obj::GetAliveObjectCount() == alive);
+    }
+    {
+        // Версии можно читать и копировать из разных потоков
+        PersistentVector<int> shared;
+        for (int i = 0; i < 5000; ++i) {
+            shared = shared.PushBack(i);
+        }
+        std::vector<std::thread> workers;
+        for (int t = 0; t < 4; ++t) {
+            workers.emplace_back([shared, t] {
+                PersistentVector<int> local = shared;
+                for (int i = 0; i < 1000; ++i) {
+                    local = local.Set(static_cast<size_t>(i * 5), t).PushBack(i);
+                }
+                assert(local.Size() == 6000 && local[0] == t && local[5999] == 999);
+            });
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        assert(shared[0] == 0 && shared[4999] == 4999);
+    }
+}
+
+void Test28() {
+    using PooledVector = Vector<int, PooledAllocator<int>>;
+    BufferPool::TrimThreadCache();
+    {
+        // Буфер того же класса ёмкости берётся из кэша потока
+        const int* first_data = nullptr;
+        {
+            PooledVector v(100);
+            first_data = v.begin();
+        }
+        assert(BufferPool::ThreadCachedBytes() == 512);
+        {
+            PooledVector v(120);
+            assert(v.begin() == first_data);
+            assert(BufferPool::ThreadCachedBytes() == 0);
+        }
+        for (int i = 0; i < 1000; ++i) {
+            PooledVector v;
+            for (int j = 0; j < 300; ++j) {
+                v.PushBack(j);
+            }
+            assert(v[299] == 299);
+        }
+
+        // Большие буферы не кэшируются
+        const size_t cached = BufferPool::ThreadCachedBytes();
+        {
+            PooledVector v(BufferPool::MAX_POOLED_BYTES / sizeof(int) + 1);
+        }
+        assert(BufferPool::ThreadCachedBytes() == cached);
+    }
+    {
+        // Кэш класса ограничен: лишние буферы уходят на склад
+        BufferPool::TrimThreadCache();
+        std::vector<PooledVector> vectors(1000);
+        for (PooledVector& v : vectors) {
+            v.Reserve(256);
+        }
+        vectors.clear();
+        assert(BufferPool::ThreadCachedBytes() <= buffer_pool_detail::THREAD_CACHE_BYTES_PER_CLASS);
+        assert(BufferPool::DepotCachedBytes() != 0);
+        BufferPool::TrimThreadCache();
+        assert(BufferPool::ThreadCachedBytes() == 0);
+    }
+    {
+        // Буферы, освобождённые в другом потоке, через склад возвращаются в оборот
+        std::vector<PooledVector> produced;
+        for (int i = 0; i < 3000; ++i) {
+            produced.emplace_back(64);
+        }
+        const size_t depot_before = BufferPool::DepotCachedBytes();
+        std::thread consumer([vectors = std::move(produced)]() mutable {
+            vectors.clear();
+        });
+        consumer.join();
+        const size_t depot_after = BufferPool::DepotCachedBytes();
+        assert(depot_after > depot_before);
+
+        std::vector<PooledVector> reused;
+        for (int i = 0; i < 100; ++i) {
+            reused.emplace_back(64);
+        }
+        assert(BufferPool::DepotCachedBytes() < depot_after);
+    }
+    {
+        // Пул используется несколькими потоками одновременно
+        std::vector<std::thread> workers;
+        for (int t = 0; t < 4; ++t) {
+            workers.emplace_back([] {
+                Vector<PooledVector, PooledAllocator<PooledVector>> batch;
+                for (int round = 0; round < 50; ++round) {
+                    for (int i = 0; i < 100; ++i) {
+                        batch.EmplaceBack(static_cast<size_t>(i * 7 + 1));
+                    }
+                    batch.Clear();
+                }
+            });
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    }
+}
+
+void Test29() {
+    using BigVector = Vector<double, HugePageAllocator<double>>;
+    const auto is_huge_page_aligned = [](const void* p) {
+        return reinterpret_cast<uintptr_t>(p) % hugepage_detail::HUGE_PAGE_SIZE == 0;
+    };
+    {
+        const HugePageAllocator<double> alloc(HugePageOptions{.threshold_bytes = size_t{1} << 20});
+        BigVector small(100, alloc);
+        BigVector big((size_t{1} << 20) / sizeof(double), alloc);
+        assert(is_huge_page_aligned(big.begin()) && big[0] == 0.0);
+
+        // Рост через порог и дальше через mremap сохраняет содержимое
+        BigVector v(alloc);
+        for (size_t i = 0; i < 1'000'000; ++i) {
+            v.PushBack(static_cast<double>(i));
+        }
+        assert(v.Capacity() * sizeof(double) >= (size_t{1} << 20));
+        for (size_t i = 0; i < v.Size(); i += 997) {
+            assert(v[i] == static_cast<double>(i));
+        }
+        v.ShrinkToFit();
+        v.Resize(10);
+        v.ShrinkToFit();
+        assert(v.Size() == 10 && v[9] == 9.0);
+
+        BigVector copy = big;
+        assert(copy.GetAllocator() == alloc && copy.Size() == big.Size());
+    }
+    {
+        // Привязка к узлу и hugetlbfs — подсказки: без поддержки память выделяется как обычно
+        const HugePageAllocator<double> alloc(
+            HugePageOptions{.threshold_bytes = size_t{1} << 16, .numa_node = 0, .use_hugetlb = true});
+        BigVector v(size_t{1} << 18, alloc);
+        std::fill(v.begin(), v.end(), 1.5);
+        assert(is_huge_page_aligned(v.begin()) && v[(size_t{1} << 18) - 1] == 1.5);
+        assert(alloc != HugePageAllocator<double>());
+    }
+}
+
+// Таблица, построенная на этапе компиляции через временный Vector
+constexpr StaticVector<int, 16> MakeSquaresTable() {
+    Vector<int> squares;
+    for (int i = 15; i >= 0; --i) {
+        squares.Insert(squares.begin(), i * i);
+    }
+    squares.Erase(squares.begin() + 3);
+    squares.Insert(squares.begin() + 3, 9);
+    StaticVector<int, 16> table;
+    for (int value : squares) {
+        table.PushBack(value);
+    }
+    return table;
+}
+
+constexpr bool CheckConstexprVector() {
+    Vector<std::string> v(3);
+    v[0] = "a";
+    v.PushBack("d");
+    v.Insert(v.begin() + 1, "b");
+    v.Insert(v.begin() + 2, 2, std::string("c"));
+    v.EraseIf([](const std::string& s) {
+        return s.empty();
+    });
+    Vector<std::string> copy = v;
+    copy.Reserve(100);
+    copy.ShrinkToFit();
+    Vector<int> numbers(10);
+    numbers.Resize(20);
+    numbers.SwapErase(numbers.begin());
+    numbers.ResizeDefaultInit(25);
+    return copy == v && v.Size() == 5 && v[0] == "a" && v[3] == "c" && v[4] == "d" && numbers.Size() == 25
+           && numbers[24] == 0;
+}
+
+void Test30() {
+    {
+        constexpr StaticVector<int, 16> SQUARES = MakeSquaresTable();
+        static_assert(SQUARES.Size() == 16 && SQUARES[3] == 9 && SQUARES[15] == 225);
+        static_assert(CheckConstexprVector());
+        static_assert(StaticVector<int, 4>{1, 2, 3} == StaticVector<int, 4>{1, 2, 3});
+        static_assert(std::is_trivially_destructible_v<StaticVector<int, 4>>);
+        assert(SQUARES[4] == 16);
+    }
+    {
+        Obj::ResetCounters();
+        {
+            StaticVector<Obj, 8> v;
+            static_assert(StaticVector<Obj, 8>::Capacity() == 8);
+            for (int i = 0; i < 6; ++i) {
+                v.EmplaceBack(i);
+            }
+            v.Insert(v.begin() + 2, Obj(100));
+            v.Erase(v.begin());
+            assert(v.Size() == 6 && v[1].id == 100 && v[5].id == 5);
+
+            // Аргумент может ссылаться на элемент самого вектора
+            v.Insert(v.begin(), v[5]);
+            assert(v[0].id == 5 && v.Size() == 7);
+
+            StaticVector<Obj, 8> copy = v;
+            StaticVector<Obj, 8> moved = std::move(copy);
+            assert(copy.Size() == 0 && moved.Size() == 7 && moved[1].id == 1);
+
+            StaticVector<Obj, 8> other(2);
+            other.Swap(moved);
+            assert(other.Size() == 7 && moved.Size() == 2 && other[6].id == 5);
+            moved = other;
+            assert(moved.Size() == 7 && moved[1].id == 1);
+            moved.Resize(3);
+            other = std::move(moved);
+            assert(other.Size() == 3 && moved.Size() == 0);
+
+            v.EmplaceBack(7);
+            try {
+                v.EmplaceBack(8);
+                assert(false);
+            } catch (const std::length_error&) {
+            }
+            assert(v.Size() == 8);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+}
+
+template <typename T>
+Vector<T> MakeVector(std::initializer_list<T> values) {
+    return Vector<T>(values.begin(), values.end());
+}
+
+void Test31() {
+    {
+        // Ветвящийся и безветвящийся поиск дают одинаковый результат
+        Vector<int> keys;
+        for (int i = 0; i < 100; ++i) {
+            keys.PushBack(i * 3);
+        }
+        for (int key = -2; key < 305; ++key) {
+            const size_t expected = std::lower_bound(keys.begin(), keys.end(), key) - keys.begin();
+            assert(flat_detail::LowerBound(keys.Data(), keys.Size(), key, std::less<int>()) == expected);
+        }
+        assert(flat_detail::LowerBound<int>(nullptr, 0, 5, std::less<int>()) == 0);
+    }
+    {
+        FlatSet<int> set(MakeVector<int>({5, 1, 3, 5, 1, 9}));
+        assert(set.Size() == 4 && std::is_sorted(set.begin(), set.end()));
+        assert(set.Contains(3) && !set.Contains(4) && *set.LowerBound(4) == 5);
+
+        assert(set.Insert(4).second && !set.Insert(4).second && set.Size() == 5);
+        assert(set.Erase(1) == 1 && set.Erase(1) == 0);
+
+        const std::vector<int> batch = {0, 2, 2, 3, 6, 10, 11};
+        set.InsertSorted(batch.begin(), batch.end());
+        assert((set == FlatSet<int>(MakeVector<int>({0, 2, 3, 4, 5, 6, 9, 10, 11}))));
+
+        const std::list<int> unsorted = {20, 7, 7, 1};
+        set.Insert(unsorted.begin(), unsorted.end());
+        assert(set.Size() == 12 && set.Contains(7) && set.Contains(20) && std::is_sorted(set.begin(), set.end()));
+        assert(set.EraseIf([](int key) {
+            return key % 2 == 0;
+        }) == 6);
+        assert(set.Size() == 6 && *set.begin() == 1);
+    }
+    {
+        FlatSet<std::string, std::greater<std::string>> words(MakeVector<std::string>({"b", "a", "c", "b"}));
+        assert(words.Size() == 3 && *words.begin() == "c");
+        const std::vector<std::string> more = {"d", "b", "a"};
+        words.InsertSorted(more.begin(), more.end());
+        assert(words.Size() == 4 && *words.begin() == "d" && *(words.end() - 1) == "a");
+    }
+    {
+        // Из повторяющихся ключей остаётся первый
+        FlatMap<int, std::string> map(MakeVector<int>({3, 1, 2, 1}),
+                                      MakeVector<std::string>({"three", "one", "two", "uno"}));
+        assert(map.Size() == 3 && *map.Find(1) == "one" && map.Find(4) == nullptr);
+        assert(map.Keys()[0] == 1 && map.Values()[2] == "three");
+
+        map[4] = "four";
+        assert(map.Size() == 4 && map.Contains(4));
+        assert(!map.TryEmplace(4, "vier").second && *map.Find(4) == "four");
+        map.InsertOrAssign(4, std::string("vier"));
+        assert(*map.Find(4) == "vier");
+        assert(map.Erase(2) == 1 && !map.Contains(2));
+
+        const std::vector<std::pair<int, std::string>> sorted = {{0, "zero"}, {1, "eins"}, {5, "five"}, {5, "fuenf"}};
+        map.InsertSorted(sorted.begin(), sorted.end());
+        assert(map.Size() == 5 && *map.Find(0) == "zero" && *map.Find(1) == "one" && *map.Find(5) == "five");
+
+        const std::map<int, std::string> ordered = {{-1, "minus"}, {3, "drei"}, {7, "seven"}};
+        map.Insert(ordered.begin(), ordered.end());
+        assert(map.Size() == 7 && *map.Find(3) == "three" && *map.Find(7) == "seven");
+        assert(std::is_sorted(map.Keys().begin(), map.Keys().end()));
+
+        assert(map.EraseIf([](int key, const std::string& value) {
+            return key < 0 || value == "four";
+        }) == 1);
+        assert(map.Size() == 6 && *map.Find(4) == "vier");
+
+        FlatMap<int, std::string> copy = map;
+        assert(copy == map);
+    }
+    {
+        // Массовая вставка не квадратична и совпадает с std::map
+        std::map<int, int> reference;
+        FlatMap<int, int> map;
+        for (int round = 0; round < 20; ++round) {
+            std::vector<std::pair<int, int>> batch;
+            for (int i = 0; i < 500; ++i) {
+                const int key = (i * 7919 + round * 104729) % 20000;
+                batch.emplace_back(key, round);
+                reference.emplace(key, round);
+            }
+            map.Insert(batch.begin(), batch.end());
+        }
+        assert(map.Size() == reference.size());
+        size_t i = 0;
+        for (const auto& [key, value] : reference) {
+            assert(map.Keys()[i] == key && map.Values()[i] == value);
+            ++i;
+        }
+    }
+    {
+        // При исключении во время копирования словарь не меняется
+        FlatMap<int, Obj> map;
+        map.TryEmplace(1, 1);
+        map.TryEmplace(3, 3);
+        std::vector<std::pair<int, Obj>> batch;
+        batch.emplace_back(2, Obj(2));
+        batch.emplace_back(4, Obj(4));
+        batch[1].second.throw_on_copy = true;
+        try {
+            map.InsertSorted(batch.begin(), batch.end());
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(map.Size() == 2 && map.Find(1)->id == 1 && map.Find(3)->id == 3);
+    }
+    {
+        // Ключи словаря не перемещаются, если перенос значения может выбросить исключение
+        struct Fragile {
+            int id = 0;
+            bool throw_on_copy = false;
+
+            explicit Fragile(int id)
+                : id(id)
+            {
+            }
+
+            Fragile(const Fragile& other)
+                : id(other.id)
+            {
+                if (other.throw_on_copy) {
+                    throw std::runtime_error("Oops");
+                }
+            }
+
+            Fragile(Fragile&& other) noexcept(false)
+                : id(other.id)
+            {
+            }
+
+            Fragile& operator=(const Fragile&) = default;
+        };
+        FlatMap<std::string, Fragile> map;
+        map.TryEmplace("a", 1);
+        map.TryEmplace("c", 3);
+        map.Find("c")->throw_on_copy = true;
+        std::vector<std::pair<std::string, Fragile>> batch;
+        batch.emplace_back("b", Fragile(2));
+        try {
+            map.InsertSorted(batch.begin(), batch.end());
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(map.Size() == 2 && map.Find("a")->id == 1 && map.Find("c")->id == 3);
+    }
+}
+
+void Test32() {
+    using CountingVector = Vector<int, std::allocator<int>, DoublingGrowth, CountingStats>;
+    Vector<int> source;
+    for (int i = 0; i < 1000; ++i) {
+        source.PushBack(i);
+    }
+    std::ranges::sort(source, std::greater<int>());
+    assert(source[0] == 999 && std::ranges::distance(source) == 1000);
+    std::ranges::sort(source);
+    assert(std::ranges::data(source) == source.Data() && std::ranges::size(source) == 1000);
+    {
+        // Размер конвейера известен заранее: одно выделение памяти
+        const VectorCounters& counters = CountingStats::Counters<int>();
+        const size_t allocations_before = counters.allocations.load();
+        auto squares = source | std::views::transform([](int x) {
+                           return x * x;
+                       })
+                       | std::views::take(100) | Collect<CountingVector>();
+        assert(squares.Size() == 100 && squares.Capacity() == 100 && squares[99] == 99 * 99);
+        assert(counters.allocations.load() == allocations_before + 1);
+
+        // Даже короткий диапазон не получает запаса ёмкости по GrowthPolicy
+        auto first_three = source | std::views::take(3) | Collect<CountingVector>();
+        assert(first_three.Size() == 3 && first_three.Capacity() == 3);
+        assert(counters.allocations.load() == allocations_before + 2);
+
+        // Непрерывный диапазон тривиальных элементов копируется целиком
+        const Vector<int> copy = Collect(std::span<const int>(source.Span().subspan(10, 20)));
+        assert(copy.Size() == 20 && copy[0] == 10 && copy[19] == 29);
+
+        // Размер отфильтрованного диапазона неизвестен: вектор растёт по политике роста
+        const Vector<int> even = source | std::views::filter([](int x) {
+                                     return x % 2 == 0;
+                                 })
+                                 | Collect();
+        assert(even.Size() == 500 && even[499] == 998);
+
+        const Vector<std::string> names = source | std::views::take(3) | std::views::transform([](int x) {
+                                              return std::to_string(x);
+                                          })
+                                          | Collect();
+        assert(names.Size() == 3 && names[2] == "2");
+    }
+    {
+        Vector<std::string> v;
+        v.PushBack("first");
+        const std::list<std::string> tail = {"a", "b"};
+        v.AppendRange(tail);
+        std::istringstream words("x y z");
+        v.AppendRange(
+            std::ranges::subrange(std::istream_iterator<std::string>(words), std::istream_iterator<std::string>()));
+        assert(v.Size() == 6 && v[2] == "b" && v[5] == "z");
+
+        // Повторные AppendRange растут по политике, а не на размер каждой порции
+        Vector<int> chunks;
+        for (int i = 0; i < 100; ++i) {
+            chunks.AppendRange(std::views::iota(0, 10));
+        }
+        assert(chunks.Size() == 1000 && chunks.Capacity() < 2048 && chunks[999] == 9);
+    }
+    {
+        // При исключении добавленные элементы удаляются
+        Obj::ResetCounters();
+        {
+            Vector<Obj> v;
+            v.EmplaceBack(1);
+            std::vector<Obj> objs(3);
+            objs[2].throw_on_copy = true;
+            try {
+                v.AppendRange(objs | std::views::all);
+                assert(false);
+            } catch (const std::runtime_error&) {
+            }
+            assert(v.Size() == 1 && v[0].id == 1);
+            try {
+                v.AppendRange(objs | std::views::filter([](const Obj&) {
+                                  return true;
+                              }));
+                assert(false);
+            } catch (const std::runtime_error&) {
+            }
+            assert(v.Size() == 1);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+}
+
+template <typename T>
+constexpr bool IS_FUZZ_VALUE = false;
+
+template <bool Relocatable, bool NothrowMove>
+constexpr bool IS_FUZZ_VALUE<FuzzValue<Relocatable, NothrowMove>> = true;
+
+template <typename T>
+int ValueOf(const T& element) {
+    if constexpr (IS_FUZZ_VALUE<T>) {
+        return element.value;
+    }
+    else {
+        return element;
+    }
+}
+
+template <typename VectorType>
+std::vector<int> ValuesOf(const VectorType& v) {
+    std::vector<int> values;
+    for (const auto& element : v) {
+        values.push_back(ValueOf(element));
+    }
+    return values;
+}
+
+template <typename VectorType>
+VectorType MakeElements(const std::vector<int>& values) {
+    VectorType v;
+    v.Reserve(values.size());
+    for (int value : values) {
+        v.EmplaceBack(value);
+    }
+    return v;
+}
+
+// Число живых элементов типа T; для неотслеживаемых типов — 0
+template <typename T>
+int AliveElements() {
+    if constexpr (IS_FUZZ_VALUE<T>) {
+        return T::num_alive;
+    }
+    else {
+        return 0;
+    }
+}
+
+// Проверяет, что живы только элементы v и n_other_alive элементов вне его
+template <typename VectorType>
+void AssertNoLeakedElements(const VectorType& v, int n_other_alive = 0) {
+    using Element = typename VectorType::value_type;
+    assert(v.Size() <= v.Capacity());
+    if constexpr (IS_FUZZ_VALUE<Element>) {
+        assert(AliveElements<Element>() == static_cast<int>(v.Size()) + n_other_alive);
+    }
+}
+
+// Выполняет op над копиями initial, внедряя отказ в 1-е, 2-е, ... выделение памяти,
+// а затем в 1-е, 2-е, ... создание элемента, пока операция не пройдёт без отказа.
+// Копия получает ту же ёмкость, что и initial, и после каждого отказа должна остаться неизменной. Возвращает число проверенных отказов
+template <typename VectorType, typename Operation>
+int CheckStrongGuarantee(const VectorType& initial, Operation op) {
+    const std::vector<int> expected = ValuesOf(initial);
+    const int n_other_alive = AliveElements<typename VectorType::value_type>();
+    int n_failures = 0;
+    for (auto arm : {&FailureInjection::ArmAllocation, &FailureInjection::ArmConstruction}) {
+        for (int n = 1;; ++n) {
+            VectorType v(initial);
+            v.Reserve(initial.Capacity());
+            arm(n);
+            try {
+                op(v);
+                FailureInjection::Disarm();
+                break;
+            } catch (...) {
+                if (!FailureInjection::fired) {
+                    throw;
+                }
+                FailureInjection::Disarm();
+            }
+            ++n_failures;
+            assert(ValuesOf(v) == expected);
+            AssertNoLeakedElements(v, n_other_alive);
+        }
+    }
+    return n_failures;
+}
+
+// Сравнивает Vector с std::vector на случайной последовательности операций, перед частью
+// которых взводится отказ. Если операция даёт строгую гарантию, после отказа вектор должен
+// совпасть с моделью; иначе проверяется только отсутствие утечек, а модель принимает
+// новое содержимое вектора
+template <typename VectorType>
+int FuzzAgainstStdVector(uint32_t seed, int num_operations) {
+    using Element = typename VectorType::value_type;
+    constexpr bool RELOCATABLE = IsTriviallyRelocatable<Element>::value;
+    constexpr bool NOTHROW_MOVE =
+        std::is_nothrow_move_constructible_v<Element> && std::is_nothrow_move_assignable_v<Element>;
+
+    std::mt19937 rng(seed);
+    auto random = [&rng](size_t bound) {
+        return static_cast<size_t>(rng() % bound);
+    };
+    auto random_values = [&random](size_t n) {
+        std::vector<int> values(n);
+        for (int& value : values) {
+            value = static_cast<int>(random(1000));
+        }
+        return values;
+    };
+
+    VectorType v;
+    std::vector<int> model;
+    int n_failures = 0;
+
+    // Выполняет op над вектором и model_op над моделью. Примерно перед третью операций
+    // взводится отказ одного из ближайших выделений памяти или созданий элемента
+    auto run = [&](bool strong, auto op, auto model_op) {
+        if (random(3) == 0) {
+            if (random(2) == 0) {
+                FailureInjection::ArmAllocation(static_cast<int>(random(2)) + 1);
+            }
+            else {
+                FailureInjection::ArmConstruction(static_cast<int>(random(6)) + 1);
+            }
+        }
+        try {
+            op();
+        } catch (...) {
+            if (!FailureInjection::fired) {
+                throw;
+            }
+            FailureInjection::Disarm();
+            ++n_failures;
+            if (strong) {
+                assert(ValuesOf(v) == model);
+            }
+            else {
+                model = ValuesOf(v);
+            }
+            return;
+        }
+        FailureInjection::Disarm();
+        model_op();
+    };
+
+    for (int i = 0; i != num_operations; ++i) {
+        const size_t size = v.Size();
+        const size_t capacity = v.Capacity();
+        // Большой вектор чаще укорачивается, чтобы размер оставался в пределах сотни элементов
+        const size_t op = size > 64 && random(2) == 0 ? 6 : random(19);
+        const size_t pos = random(size + 1);
+        switch (op) {
+        case 0: {
+            const Element value(static_cast<int>(random(1000)));
+            run(true, [&] { v.PushBack(value); }, [&] { model.push_back(ValueOf(value)); });
+            break;
+        }
+        case 1: {
+            const int value = static_cast<int>(random(1000));
+            run(true, [&] { v.EmplaceBack(value); }, [&] { model.push_back(value); });
+            break;
+        }
+        case 2: {
+            const Element value(static_cast<int>(random(1000)));
+            run(NOTHROW_MOVE || pos == size || size == capacity,
+                [&] { v.Insert(v.begin() + pos, value); },
+                [&] { model.insert(model.begin() + pos, ValueOf(value)); });
+            break;
+        }
+        case 3: {
+            const size_t n = random(8);
+            const Element value(static_cast<int>(random(1000)));
+            run(RELOCATABLE || pos == size || size + n > capacity,
+                [&] { v.Insert(v.begin() + pos, n, value); },
+                [&] { model.insert(model.begin() + pos, n, ValueOf(value)); });
+            break;
+        }
+        case 4: {
+            const std::vector<int> values = random_values(random(8));
+            const VectorType source = MakeElements<VectorType>(values);
+            run(RELOCATABLE || pos == size || size + values.size() > capacity,
+                [&] { v.Insert(v.begin() + pos, source.begin(), source.end()); },
+                [&] { model.insert(model.begin() + pos, values.begin(), values.end()); });
+            break;
+        }
+        case 5:
+            if (pos != size) {
+                run(NOTHROW_MOVE, [&] { v.Erase(v.begin() + pos); }, [&] { model.erase(model.begin() + pos); });
+            }
+            break;
+        case 6: {
+            const size_t last = pos + random(size - pos + 1);
+            run(NOTHROW_MOVE, [&] { v.Erase(v.begin() + pos, v.begin() + last); },
+                [&] { model.erase(model.begin() + pos, model.begin() + last); });
+            break;
+        }
+        case 7:
+            if (pos != size) {
+                run(NOTHROW_MOVE, [&] { v.SwapErase(v.begin() + pos); },
+                    [&] {
+                        model[pos] = model.back();
+                        model.pop_back();
+                    });
+            }
+            break;
+        case 8:
+            if (random(8) == 0) {
+                run(true, [&] { v.Clear(); }, [&] { model.clear(); });
+            }
+            else if (size != 0) {
+                run(true, [&] { v.PopBack(); }, [&] { model.pop_back(); });
+            }
+            break;
+        case 9: {
+            const size_t new_size = random(size + 16);
+            run(true, [&] { v.Resize(new_size); }, [&] { model.resize(new_size); });
+            break;
+        }
+        case 10: {
+            const size_t new_capacity = random(2 * size + 16);
+            run(true, [&] { v.Reserve(new_capacity); }, [] {});
+            break;
+        }
+        case 11:
+            run(true, [&] { v.ShrinkToFit(); }, [] {});
+            break;
+        case 12: {
+            const std::vector<int> values = random_values(random(8));
+            run(true,
+                [&] {
+                    v.AppendRange(values | std::views::transform([](int value) {
+                                      return Element(value);
+                                  }));
+                },
+                [&] { model.insert(model.end(), values.begin(), values.end()); });
+            break;
+        }
+        case 13: {
+            const std::vector<int> values = random_values(random(8));
+            const VectorType source = MakeElements<VectorType>(values);
+            run(true, [&] { v.AppendRange(source); },
+                [&] { model.insert(model.end(), values.begin(), values.end()); });
+            break;
+        }
+        case 14: {
+            const std::vector<int> values = random_values(random(2 * size + 8));
+            const VectorType source = MakeElements<VectorType>(values);
+            run(values.size() > capacity, [&] { v = source; }, [&] { model = values; });
+            break;
+        }
+        case 15:
+            run(true,
+                [&] {
+                    VectorType copy(v);
+                    v = std::move(copy);
+                },
+                [] {});
+            break;
+        case 16: {
+            auto is_odd = [](const Element& element) {
+                return ValueOf(element) % 2 != 0;
+            };
+            run(NOTHROW_MOVE, [&] { v.EraseIf(is_odd); },
+                [&] {
+                    std::erase_if(model, [](int value) {
+                        return value % 2 != 0;
+                    });
+                });
+            break;
+        }
+        case 17: {
+            const size_t new_size = random(size + 32);
+            run(true, [&] { v.ParallelResize(new_size, {.num_threads = 3, .min_elements_per_thread = 4}); },
+                [&] { model.resize(new_size); });
+            break;
+        }
+        case 18: {
+            VectorType other = MakeElements<VectorType>(random_values(random(8)));
+            std::vector<int> other_model = ValuesOf(other);
+            run(true, [&] { v.Swap(other); }, [&] { model.swap(other_model); });
+            break;
+        }
+        }
+        assert(ValuesOf(v) == model);
+        AssertNoLeakedElements(v);
+    }
+    return n_failures;
+}
+
+// Отказы в каждой точке быстрых путей, которые должны давать строгую гарантию
+template <typename VectorType>
+void CheckStrongGuaranteePaths() {
+    using Element = typename VectorType::value_type;
+
+    // Полный буфер: любое добавление перевыделяет память
+    VectorType full = MakeElements<VectorType>({1, 2, 3, 4, 5, 6, 7, 8});
+    full.ShrinkToFit();
+    assert(full.Size() == full.Capacity());
+    const VectorType source = MakeElements<VectorType>({10, 11, 12});
+
+    auto check = [](const VectorType& initial, auto op) {
+        const int n_failures = CheckStrongGuarantee(initial, op);
+        assert(n_failures > 0);
+    };
+
+    check(full, [](VectorType& v) {
+        v.EmplaceBack(9);
+    });
+    check(full, [](VectorType& v) {
+        v.PushBack(v[0]);
+    });
+    check(full, [](VectorType& v) {
+        v.Insert(v.begin() + 3, Element(9));
+    });
+    check(full, [](VectorType& v) {
+        v.Insert(v.begin() + 3, 4, v[5]);
+    });
+    check(full, [&source](VectorType& v) {
+        v.Insert(v.begin() + 3, source.begin(), source.end());
+    });
+    check(full, [&source](VectorType& v) {
+        v.AppendRange(source);
+    });
+    check(full, [](VectorType& v) {
+        v.Reserve(100);
+    });
+    check(full, [](VectorType& v) {
+        v.Resize(20);
+    });
+    check(full, [](VectorType& v) {
+        v.ParallelResize(40, {.num_threads = 4, .min_elements_per_thread = 4});
+    });
+    check(full, [](VectorType& v) {
+        VectorType copy(v);
+        v.Swap(copy);
+    });
+    check(full, [](const VectorType& v) {
+        VectorType copy(v, ParallelOptions{.num_threads = 4, .min_elements_per_thread = 2});
+    });
+
+    VectorType spare = full;
+    spare.Reserve(32);
+    spare.Resize(16);
+    check(spare, [](VectorType& v) {
+        v.ShrinkToFit();
+    });
+    if constexpr (IS_FUZZ_VALUE<Element>) {
+        // Без перевыделения отказать может только создание элемента
+        check(spare, [](VectorType& v) {
+            v.Resize(20);
+        });
+        if constexpr (std::is_nothrow_move_constructible_v<Element> && std::is_nothrow_move_assignable_v<Element>) {
+            // Сдвиг хвоста перемещениями сохраняет вектор, только если они не выбрасывают исключений
+            check(spare, [](VectorType& v) {
+                v.Insert(v.begin() + 2, Element(9));
+            });
+        }
+        if constexpr (IsTriviallyRelocatable<Element>::value) {
+            // Вставку нескольких элементов без перевыделения откатывает только побайтовый сдвиг хвоста
+            check(spare, [](VectorType& v) {
+                v.Insert(v.begin() + 2, 4, v[0]);
+            });
+            check(spare, [&source](VectorType& v) {
+                v.Insert(v.begin() + 2, source.begin(), source.end());
+            });
+        }
+    }
+}
+
+void Test33() {
+    using Relocatable = FuzzValue<true, true>;
+    using NothrowMove = FuzzValue<false, true>;
+    using ThrowingMove = FuzzValue<false, false>;
+    {
+        CheckStrongGuaranteePaths<Vector<Relocatable, FailingAllocator<Relocatable>>>();
+        CheckStrongGuaranteePaths<Vector<Relocatable, FailingAllocator<Relocatable, true>>>();
+        CheckStrongGuaranteePaths<Vector<NothrowMove, FailingAllocator<NothrowMove>>>();
+        CheckStrongGuaranteePaths<Vector<ThrowingMove, FailingAllocator<ThrowingMove>>>();
+        CheckStrongGuaranteePaths<Vector<int, FailingAllocator<int, true>>>();
+        assert(Relocatable::num_alive == 0 && NothrowMove::num_alive == 0 && ThrowingMove::num_alive == 0);
+        assert(FailureInjection::live_allocations == 0);
+    }
+    {
+        int n_failures = 0;
+        for (uint32_t seed = 1; seed != 4; ++seed) {
+            n_failures += FuzzAgainstStdVector<Vector<Relocatable, FailingAllocator<Relocatable>>>(seed, 2000);
+            n_failures += FuzzAgainstStdVector<Vector<Relocatable, FailingAllocator<Relocatable, true>>>(seed, 2000);
+            n_failures += FuzzAgainstStdVector<Vector<NothrowMove, FailingAllocator<NothrowMove>>>(seed, 2000);
+            n_failures += FuzzAgainstStdVector<Vector<ThrowingMove, FailingAllocator<ThrowingMove>>>(seed, 2000);
+            n_failures += FuzzAgainstStdVector<Vector<int, FailingAllocator<int, true>>>(seed, 2000);
+        }
+        assert(n_failures > 0);
+        assert(Relocatable::num_alive == 0 && NothrowMove::num_alive == 0 && ThrowingMove::num_alive == 0);
+        assert(FailureInjection::live_allocations == 0);
+    }
+}
+
+template <size_t Bits>
+void CheckPackedIntVector() {
+    using Packed = PackedIntVector<Bits>;
+    using Value = typename Packed::value_type;
+    std::mt19937_64 rng(Bits);
+    std::vector<Value> reference(300);
+    for (Value& value : reference) {
+        value = static_cast<Value>(rng() & Packed::MAX_VALUE);
+    }
+    {
+        Packed packed;
+        for (Value value : reference) {
+            packed.PushBack(value);
+        }
+        assert(packed.Size() == reference.size());
+        assert(packed.Words().size() == (reference.size() * Bits + 63) / 64);
+        for (size_t i = 0; i != reference.size(); ++i) {
+            assert(packed[i] == reference[i]);
+        }
+        // Блочная упаковка даёт те же слова, что и поэлементная
+        Packed appended;
+        appended.PushBack(reference[0]);
+        appended.Append(std::span(reference).subspan(1));
+        assert(appended == packed);
+
+        // Распаковка с произвольного места: голова до границы блока, целые блоки и хвост
+        for (size_t first : {0, 1, 63, 64, 100}) {
+            std::vector<Value> decoded(reference.size() - first - 5);
+            packed.Decode(first, decoded);
+            assert(std::equal(decoded.begin(), decoded.end(), reference.begin() + first));
+        }
+        const Vector<Value> all = packed.ToVector();
+        assert(std::equal(all.begin(), all.end(), reference.begin(), reference.end()));
+
+        // Запись не задевает соседей, в том числе через границу слов
+        for (size_t i = 0; i < reference.size(); i += 7) {
+            reference[i] = Packed::MAX_VALUE - reference[i];
+            packed.Set(i, reference[i]);
+        }
+        for (size_t i = 0; i != reference.size(); ++i) {
+            assert(packed[i] == reference[i]);
+        }
+
+        // Биты за пределами размера обнуляются, поэтому сравнение по словам остаётся верным
+        packed.Resize(10);
+        packed.Resize(200);
+        packed.PopBack();
+        packed.PopBack();
+        assert(packed.Size() == 198);
+        for (size_t i = 0; i != 10; ++i) {
+            assert(packed[i] == reference[i]);
+        }
+        for (size_t i = 10; i != packed.Size(); ++i) {
+            assert(packed[i] == 0);
+        }
+        Packed expected(198);
+        for (size_t i = 0; i != 10; ++i) {
+            expected.Set(i, reference[i]);
+        }
+        assert(packed == expected);
+    }
+}
+
+void Test34() {
+    {
+        // Сравнение с std::vector<bool> на случайных операциях
+        std::mt19937 rng(34);
+        BitVector<> bits;
+        std::vector<bool> reference;
+        for (int i = 0; i != 5000; ++i) {
+            const size_t op = rng() % 6;
+            if (op <= 2) {
+                const bool value = rng() % 3 == 0;
+                bits.PushBack(value);
+                reference.push_back(value);
+            }
+            else if (op == 3 && !reference.empty()) {
+                bits.PopBack();
+                reference.pop_back();
+            }
+            else if (op == 4 && !reference.empty()) {
+                const size_t index = rng() % reference.size();
+                bits.Flip(index);
+                reference[index] = !reference[index];
+            }
+            else if (op == 5 && rng() % 16 == 0) {
+                const size_t new_size = rng() % 300;
+                const bool value = rng() % 2 == 0;
+                bits.Resize(new_size, value);
+                reference.resize(new_size, value);
+            }
+        }
+        assert(bits.Size() == reference.size());
+        for (size_t i = 0; i != reference.size(); ++i) {
+            assert(bits[i] == reference[i]);
+        }
+        assert(bits.Count() == static_cast<size_t>(std::count(reference.begin(), reference.end(), true)));
+
+        std::vector<size_t> set_bits;
+        bits.ForEachSetBit([&set_bits](size_t index) {
+            set_bits.push_back(index);
+        });
+        std::vector<size_t> found;
+        for (size_t i = bits.FindFirst(); i != bits.Size(); i = bits.FindNext(i + 1)) {
+            found.push_back(i);
+        }
+        assert(found == set_bits && set_bits.size() == bits.Count());
+        for (size_t index : set_bits) {
+            assert(reference[index]);
+        }
+    }
+    {
+        BitVector<> empty;
+        assert(empty.Size() == 0 && empty.Count() == 0 && empty.None() && empty.All());
+        assert(empty.FindFirst() == 0);
+
+        BitVector<> a(130);
+        BitVector<> b(130, true);
+        assert(a.None() && b.All() && b.Count() == 130);
+        assert(b.Words().size() == 3 && b.Words()[2] == 0b11);
+        a.Set(0);
+        a.Set(64);
+        a.Set(129);
+        assert(a.FindFirst() == 0 && a.FindNext(1) == 64 && a.FindNext(65) == 129 && a.FindNext(130) == 130);
+        assert((a & b) == a && (a | b) == b && (a ^ b).Count() == 127);
+        assert(CountCommon(a, b) == 3);
+
+        BitVector<> c = b;
+        c.AndNot(a);
+        assert(c.Count() == 127 && !c[0] && c[1] && !c[129]);
+        c.FlipAll();
+        // Лишние биты последнего слова остаются нулевыми
+        assert(c == a && c.Words()[2] == 0b10);
+        c.Fill(true);
+        assert(c == b);
+        c.Reset(5);
+        c.Resize(3);
+        assert(c.Size() == 3 && c.Count() == 3);
+        c.Resize(70, false);
+        assert(c.Count() == 3 && c.FindNext(3) == 70);
+        c.Clear();
+        assert(c.Size() == 0 && c.Capacity() >= 70);
+    }
+    {
+        CheckPackedIntVector<1>();
+        CheckPackedIntVector<7>();
+        CheckPackedIntVector<20>();
+        CheckPackedIntVector<32>();
+        CheckPackedIntVector<33>();
+        CheckPackedIntVector<64>();
+        static_assert(std::is_same_v<PackedIntVector<20>::value_type, uint32_t>);
+        static_assert(std::is_same_v<PackedIntVector<33>::value_type, uint64_t>);
+
+        PackedIntVector<20> ids;
+        ids.Reserve(1000);
+        assert(ids.Capacity() >= 1000);
+        for (uint32_t i = 0; i != 1000; ++i) {
+            ids.PushBack(i * 1000 % (1 << 20));
+        }
+        assert(ids.Words().size() * sizeof(uint64_t) == 2504);
+        assert(ids[999] == 999000 % (1 << 20));
+    }
+}
+
+void Test35() {
+    // Производитель, отдающий числа 0, 1, ... n - 1 порциями неровного размера, как сокет
+    struct CountingProducer {
+        size_t next = 0;
+        size_t n = 0;
+
+        size_t operator()(std::span<int> chunk) {
+            const size_t count = std::min({chunk.size(), n - next, next % 7 + 1});
+            for (size_t i = 0; i != count; ++i) {
+                chunk[i] = static_cast<int>(next++);
+            }
+            return count;
+        }
+    };
+    const size_t n = 20000;
+    {
+        // Потребитель читает заполненное начало, пока фоновый поток дописывает остальное
+        Vector<int> v;
+        StreamingFill fill(v, CountingProducer{0, n}, {.chunk_size = 256, .expected_size = n});
+        long long sum = 0;
+        size_t consumed = 0;
+        std::thread consumer([&] {
+            while (consumed != n) {
+                std::span<const int> prefix = fill.WaitFor(consumed + 1);
+                for (; consumed != prefix.size(); ++consumed) {
+                    assert(prefix[consumed] == static_cast<int>(consumed));
+                    sum += prefix[consumed];
+                }
+            }
+        });
+        consumer.join();
+        const int* data = v.Data();
+        fill.Finish();
+        assert(fill.Done());
+        assert(sum == static_cast<long long>(n) * (n - 1) / 2);
+        // Точная оценка размера: данные записаны в зарезервированный буфер без перевыделений
+        assert(v.Size() == n && v.Data() == data);
+    }
+    {
+        // Источник длиннее резерва: остаток дочитывает Finish
+        Vector<int> v;
+        v.PushBack(-1);
+        StreamingFill fill(v, CountingProducer{0, n}, {.chunk_size = 100, .expected_size = 1000});
+        assert(fill.WaitFor(n).size() <= 1 + 11 * 100);
+        fill.Finish();
+        assert(v.Size() == n + 1 && v[0] == -1);
+        for (size_t i = 0; i != n; ++i) {
+            assert(v[i + 1] == static_cast<int>(i));
+        }
+    }
+    {
+        // Исключение производителя пробрасывается из Finish, готовые порции остаются в векторе
+        Vector<AtomicObj> v;
+        size_t calls = 0;
+        auto producer = [&calls](std::span<AtomicObj> chunk) -> size_t {
+            if (++calls == 4) {
+                throw std::runtime_error("Oops");
+            }
+            for (size_t i = 0; i != chunk.size(); ++i) {
+                chunk[i].id = static_cast<int>((calls - 1) * chunk.size() + i);
+            }
+            return chunk.size();
+        };
+        StreamingFill fill(v, producer, {.chunk_size = 10, .expected_size = 1000});
+        try {
+            fill.Finish();
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == 30 && v[29].id == 29);
+        assert(AtomicObj::num_alive == 30);
+        fill.Finish();
+        assert(v.Size() == 30);
+    }
+    assert(AtomicObj::num_alive == 0);
+    {
+        // Отмена и разрушение без Finish не ждут исчерпания бесконечного источника
+        Vector<int> v;
+        {
+            // Семнадцатый вызов производителя ждёт, пока тест вызовет Cancel, поэтому
+            // фоновый поток записывает ровно 17 порций
+            std::latch started(1);
+            std::latch cancelled(1);
+            size_t calls = 0;
+            StreamingFill fill(
+                v,
+                [&calls, &started, &cancelled](std::span<int> chunk) {
+                    if (++calls == 17) {
+                        started.count_down();
+                        cancelled.wait();
+                    }
+                    std::fill(chunk.begin(), chunk.end(), 7);
+                    return chunk.size();
+                },
+                {.chunk_size = 64, .expected_size = size_t{1} << 20});
+            started.wait();
+            assert(fill.WaitFor(16 * 64).size() == 16 * 64);
+            fill.Cancel();
+            cancelled.count_down();
+            fill.Finish();
+            assert(v.Size() == 17 * 64 && calls == 17);
+        }
+        {
+            StreamingFill fill(v, [](std::span<int> chunk) {
+                return chunk.size();
+            });
+        }
+        assert(v.Size() % 64 == 0);
+    }
+    {
+        // Чтение байтов из потока: промежуточного буфера нет, обрыв посреди элемента — ошибка
+        std::vector<uint64_t> values(5000);
+        std::iota(values.begin(), values.end(), 0);
+        std::string bytes(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(uint64_t));
+
+        std::istringstream in(bytes);
+        Vector<uint64_t> v;
+        StreamingFill fill(v, StreamProducer<uint64_t>(in), {.chunk_size = 512, .expected_size = values.size()});
+        fill.Finish();
+        assert(std::equal(v.begin(), v.end(), values.begin(), values.end()));
+
+        std::istringstream truncated(bytes.substr(0, bytes.size() - 3));
+        Vector<uint64_t> w;
+        StreamingFill truncated_fill(w, StreamProducer<uint64_t>(truncated), {.chunk_size = 512});
+        try {
+            truncated_fill.Finish();
+            assert(false);
+        } catch (const std::runtime_error&) {
         }
-        Dump();
-    } catch (...) {
+        assert(w.Size() % 512 == 0 && w.Size() < values.size());
     }
 }
 
@@ -647,7 +3388,35 @@ int main() {
         Test4();
         Test5();
         Test6();
-        Benchmark();
+        Test7();
+        Test8();
+        Test9();
+        Test10();
+        Test11();
+        Test12();
+        Test13();
+        Test14();
+        Test15();
+        Test16();
+        Test17();
+        Test18();
+        Test19();
+        Test20();
+        Test21();
+        Test22();
+        Test23();
+        Test24();
+        Test25();
+        Test26();
+        Test27();
+        Test28();
+        Test29();
+        Test30();
+        Test31();
+        Test32();
+        Test33();
+        Test34();
+        Test35();
     } catch (const std::exception& e) {
         std::cerr << e.what() << std::endl;
     }
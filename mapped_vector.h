@@ -0,0 +1,306 @@
+#pragma once
+#include "vector.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <typeinfo>
+
+enum class MapMode {
+    // Изменения попадают в файл
+    SHARED,
+    // Файл только читается, изменения видны лишь этому объекту
+    PRIVATE,
+};
+
+// Вектор тривиально копируемых элементов в отображённом в память файле.
+// Файл начинается с заголовка (размер, ёмкость, контрольная сумма типа), за ним с выравниванием
+// по кэш-линии лежат элементы. Открытие не читает данные: страницы подгружаются при первом
+// обращении. В режиме SHARED рост выполняется через ftruncate и mremap без копирования,
+// а Flush() синхронно записывает изменения на диск через msync. В режиме PRIVATE файл
+// не изменяется, а при росте элементы копируются в анонимную память.
+template <typename T, typename GrowthPolicy = DoublingGrowth>
+class MappedVector {
+    static_assert(std::is_trivially_copyable_v<T>, "MappedVector requires trivially copyable elements");
+
+    struct Header {
+        uint64_t magic;
+        uint64_t type_checksum;
+        uint64_t size;
+        uint64_t capacity;
+    };
+
+    static constexpr uint64_t MAGIC = 0x31524f5443455656;  // "VVECTOR1"
+    static constexpr size_t DATA_OFFSET =
+        (sizeof(Header) + std::max(CACHE_LINE_SIZE, alignof(T)) - 1) & ~(std::max(CACHE_LINE_SIZE, alignof(T)) - 1);
+
+public:
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    // Открывает файл, создавая пустой вектор, если файла нет или он пуст (только в режиме SHARED).
+    // Выбрасывает std::system_error при ошибке системного вызова и std::runtime_error,
+    // если заголовок повреждён или записан для другого типа элементов
+    explicit MappedVector(const std::string& path, MapMode mode = MapMode::SHARED)
+        : mode_(mode)
+    {
+        fd_ = ::open(path.c_str(), mode == MapMode::SHARED ? O_RDWR | O_CREAT : O_RDONLY, 0644);
+        if (fd_ < 0) {
+            throw std::system_error(errno, std::generic_category(), "open " + path);
+        }
+        try {
+            struct stat file_stat {};
+            if (::fstat(fd_, &file_stat) != 0) {
+                throw std::system_error(errno, std::generic_category(), "fstat " + path);
+            }
+            const size_t file_size = static_cast<size_t>(file_stat.st_size);
+            if (file_size == 0 && mode == MapMode::SHARED) {
+                Truncate(DATA_OFFSET);
+                Map(DATA_OFFSET);
+                GetHeader() = Header{MAGIC, TypeChecksum(), 0, 0};
+                return;
+            }
+            if (file_size < DATA_OFFSET) {
+                throw std::runtime_error("MappedVector: file is too small: " + path);
+            }
+            Map(file_size);
+            const Header& header = GetHeader();
+            if (header.magic != MAGIC || header.type_checksum != TypeChecksum()) {
+                throw std::runtime_error("MappedVector: header does not match the element type: " + path);
+            }
+            // Ёмкость сравнивается с частным, чтобы огромное значение из испорченного файла не переполнило произведение
+            if (header.size > header.capacity || header.capacity > (file_size - DATA_OFFSET) / sizeof(T)) {
+                throw std::runtime_error("MappedVector: corrupted header: " + path);
+            }
+        } catch (...) {
+            Close();
+            throw;
+        }
+    }
+
+    MappedVector(const MappedVector&) = delete;
+    MappedVector& operator=(const MappedVector&) = delete;
+
+    // Перемещённый объект можно только разрушить или присвоить ему другой
+    MappedVector(MappedVector&& other) noexcept
+        : mode_(other.mode_)
+        , fd_(std::exchange(other.fd_, -1))
+        , base_(std::exchange(other.base_, nullptr))
+        , mapped_bytes_(std::exchange(other.mapped_bytes_, 0))
+        , file_backed_(other.file_backed_)
+    {
+    }
+
+    MappedVector& operator=(MappedVector&& rhs) noexcept {
+        if (this != &rhs) {
+            Close();
+            mode_ = rhs.mode_;
+            fd_ = std::exchange(rhs.fd_, -1);
+            base_ = std::exchange(rhs.base_, nullptr);
+            mapped_bytes_ = std::exchange(rhs.mapped_bytes_, 0);
+            file_backed_ = rhs.file_backed_;
+        }
+        return *this;
+    }
+
+    // В режиме SHARED изменения остаются в страничном кэше и записываются ядром позже;
+    // для гарантированной записи нужен Flush()
+    ~MappedVector() {
+        Close();
+    }
+
+    size_t Size() const noexcept {
+        return GetHeader().size;
+    }
+
+    size_t Capacity() const noexcept {
+        return GetHeader().capacity;
+    }
+
+    void Reserve(size_t new_capacity) {
+        if (new_capacity > Capacity()) {
+            Grow(new_capacity);
+        }
+    }
+
+    // Новые элементы инициализируются значением (обнуляются)
+    void Resize(size_t new_size) {
+        Reserve(new_size);
+        if (new_size > Size()) {
+            std::uninitialized_value_construct(end(), Data() + new_size);
+        }
+        GetHeader().size = new_size;
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        if (Size() == Capacity()) {
+            Grow(GrowthPolicy::NextCapacity(Size(), sizeof(T)));
+        }
+        T* slot = new (end()) T(std::forward<Args>(args)...);
+        ++GetHeader().size;
+        return *slot;
+    }
+
+    void PopBack() noexcept {
+        if (Size() != 0) {
+            --GetHeader().size;
+        }
+    }
+
+    void Clear() noexcept {
+        GetHeader().size = 0;
+    }
+
+    // Синхронно записывает изменения на диск. В режиме PRIVATE ничего не делает
+    void Flush() {
+        if (file_backed_ && mode_ == MapMode::SHARED && ::msync(base_, mapped_bytes_, MS_SYNC) != 0) {
+            throw std::system_error(errno, std::generic_category(), "msync");
+        }
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < Size());
+        return Data()[index];
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<MappedVector&>(*this)[index];
+    }
+
+    std::span<T> Span() noexcept {
+        return {Data(), Size()};
+    }
+
+    std::span<const T> Span() const noexcept {
+        return {Data(), Size()};
+    }
+
+    iterator begin() noexcept { return Data(); }
+    iterator end() noexcept { return Data() + Size(); }
+    const_iterator begin() const noexcept { return Data(); }
+    const_iterator end() const noexcept { return Data() + Size(); }
+    const_iterator cbegin() const noexcept { return Data(); }
+    const_iterator cend() const noexcept { return Data() + Size(); }
+
+private:
+    MapMode mode_;
+    int fd_ = -1;
+    std::byte* base_ = nullptr;
+    size_t mapped_bytes_ = 0;
+    // false, когда в режиме PRIVATE данные перенесены в анонимную память
+    bool file_backed_ = true;
+
+    // Размер, выравнивание и имя типа; имя зависит от компилятора, поэтому файлы
+    // переносимы только между программами, собранными одним компилятором
+    static uint64_t TypeChecksum() noexcept {
+        uint64_t hash = 0xcbf29ce484222325;  // FNV-1a
+        auto mix = [&hash](uint64_t value) {
+            hash = (hash ^ value) * 0x100000001b3;
+        };
+        mix(sizeof(T));
+        mix(alignof(T));
+        for (const char* c = typeid(T).name(); *c != '\0'; ++c) {
+            mix(static_cast<unsigned char>(*c));
+        }
+        return hash;
+    }
+
+    Header& GetHeader() noexcept {
+        return *reinterpret_cast<Header*>(base_);
+    }
+
+    const Header& GetHeader() const noexcept {
+        return *reinterpret_cast<const Header*>(base_);
+    }
+
+    T* Data() noexcept {
+        return reinterpret_cast<T*>(base_ + DATA_OFFSET);
+    }
+
+    const T* Data() const noexcept {
+        return reinterpret_cast<const T*>(base_ + DATA_OFFSET);
+    }
+
+    void Truncate(size_t bytes) {
+        if (::ftruncate(fd_, static_cast<off_t>(bytes)) != 0) {
+            throw std::system_error(errno, std::generic_category(), "ftruncate");
+        }
+    }
+
+    void Map(size_t bytes) {
+        const int prot = PROT_READ | PROT_WRITE;
+        const int flags = mode_ == MapMode::SHARED ? MAP_SHARED : MAP_PRIVATE;
+        void* p = ::mmap(nullptr, bytes, prot, flags, fd_, 0);
+        if (p == MAP_FAILED) {
+            throw std::system_error(errno, std::generic_category(), "mmap");
+        }
+        base_ = static_cast<std::byte*>(p);
+        mapped_bytes_ = bytes;
+    }
+
+    void Grow(size_t new_capacity) {
+        if (new_capacity > (std::numeric_limits<size_t>::max() - DATA_OFFSET) / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        const size_t new_bytes = DATA_OFFSET + new_capacity * sizeof(T);
+        if (mode_ == MapMode::SHARED) {
+            Truncate(new_bytes);
+            Remap(new_bytes);
+        }
+        else {
+            // Страницы за концом файла в частном отображении недоступны, поэтому данные
+            // переносятся в анонимную память
+            void* p = ::mmap(nullptr, new_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (p == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+            std::memcpy(p, base_, DATA_OFFSET + Size() * sizeof(T));
+            ::munmap(base_, mapped_bytes_);
+            base_ = static_cast<std::byte*>(p);
+            mapped_bytes_ = new_bytes;
+            file_backed_ = false;
+        }
+        GetHeader().capacity = new_capacity;
+    }
+
+    void Remap(size_t new_bytes) {
+#ifdef __linux__
+        void* p = ::mremap(base_, mapped_bytes_, new_bytes, MREMAP_MAYMOVE);
+        if (p == MAP_FAILED) {
+            throw std::system_error(errno, std::generic_category(), "mremap");
+        }
+        base_ = static_cast<std::byte*>(p);
+        mapped_bytes_ = new_bytes;
+#else
+        std::byte* old_base = base_;
+        const size_t old_bytes = mapped_bytes_;
+        Map(new_bytes);
+        ::munmap(old_base, old_bytes);
+#endif
+    }
+
+    void Close() noexcept {
+        if (base_ != nullptr) {
+            ::munmap(base_, mapped_bytes_);
+            base_ = nullptr;
+            mapped_bytes_ = 0;
+        }
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+};
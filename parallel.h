@@ -0,0 +1,111 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+// Параметры распараллеливания массовых операций над элементами Vector
+struct ParallelOptions {
+    // Число потоков; 0 — по числу аппаратных потоков
+    size_t num_threads = 0;
+    // Меньшие диапазоны не делятся: запуск потока дороже обработки такого количества элементов
+    size_t min_elements_per_thread = size_t{1} << 16;
+
+    size_t ChunkCount(size_t n) const noexcept {
+        const size_t threads = num_threads != 0 ? num_threads : std::max(1u, std::thread::hardware_concurrency());
+        return std::clamp<size_t>(n / std::max<size_t>(min_elements_per_thread, 1), 1, threads);
+    }
+};
+
+namespace parallel_detail {
+
+// Делит [0, n) на num_chunks почти равных частей и вызывает task(chunk, first, last) для каждой.
+// Первая часть обрабатывается вызывающим потоком, остальные — отдельными потоками.
+// Если поток не удаётся запустить, его часть выполняется в вызывающем потоке. task не выбрасывает исключений
+template <typename Task>
+void RunChunks(size_t n, size_t num_chunks, Task& task) noexcept {
+    auto chunk_begin = [n, num_chunks](size_t chunk) {
+        return n / num_chunks * chunk + std::min(chunk, n % num_chunks);
+    };
+    std::vector<std::thread> workers;
+    try {
+        workers.reserve(num_chunks - 1);
+    } catch (...) {
+    }
+    for (size_t chunk = 1; chunk < num_chunks; ++chunk) {
+        const size_t first = chunk_begin(chunk);
+        const size_t last = chunk_begin(chunk + 1);
+        try {
+            workers.emplace_back([&task, chunk, first, last] {
+                task(chunk, first, last);
+            });
+        } catch (...) {
+            task(chunk, first, last);
+        }
+    }
+    task(size_t{0}, size_t{0}, chunk_begin(1));
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+}  // namespace parallel_detail
+
+// Вызывает task(first, last) для частей [0, n), обрабатывая их параллельно.
+// task не должен выбрасывать исключений
+template <typename Task>
+void ParallelFor(size_t n, const ParallelOptions& options, Task task) noexcept {
+    const size_t num_chunks = options.ChunkCount(n);
+    if (num_chunks <= 1) {
+        task(size_t{0}, n);
+        return;
+    }
+    auto chunk_task = [&task](size_t /*chunk*/, size_t first, size_t last) noexcept {
+        task(first, last);
+    };
+    parallel_detail::RunChunks(n, num_chunks, chunk_task);
+}
+
+// Создаёт n объектов, обрабатывая части [0, n) параллельно. construct(first, last) создаёт объекты
+// [first, last) и при исключении сам разрушает свою незавершённую часть. Если какая-либо часть
+// выбросила исключение, destroy(first, last) разрушает успешно созданные части,
+// после чего первое исключение пробрасывается дальше
+template <typename Construct, typename Destroy>
+void ParallelConstruct(size_t n, const ParallelOptions& options, Construct construct, Destroy destroy) {
+    const size_t num_chunks = options.ChunkCount(n);
+    if (num_chunks <= 1) {
+        construct(size_t{0}, n);
+        return;
+    }
+    struct ChunkResult {
+        size_t first = 0;
+        size_t last = 0;
+        std::exception_ptr error;
+    };
+    // Каждый поток пишет только в свой элемент results
+    std::vector<ChunkResult> results(num_chunks);
+    auto chunk_task = [&construct, &results](size_t chunk, size_t first, size_t last) noexcept {
+        ChunkResult& result = results[chunk];
+        result.first = first;
+        result.last = last;
+        try {
+            construct(first, last);
+        } catch (...) {
+            result.error = std::current_exception();
+        }
+    };
+    parallel_detail::RunChunks(n, num_chunks, chunk_task);
+
+    auto failed = std::find_if(results.begin(), results.end(), [](const ChunkResult& result) {
+        return result.error != nullptr;
+    });
+    if (failed != results.end()) {
+        for (const ChunkResult& result : results) {
+            if (!result.error) {
+                destroy(result.first, result.last);
+            }
+        }
+        std::rethrow_exception(failed->error);
+    }
+}
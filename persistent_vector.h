@@ -0,0 +1,553 @@
+#pragma once
+#include "vector.h"
+
+#include <atomic>
+#include <cstdint>
+
+// Неизменяемый вектор со структурным разделением: префиксное дерево с 32 потомками в узле
+// и отдельным хвостовым листом, как в Clojure и immer. PushBack, Set и PopBack возвращают
+// новую версию за O(log32 n), копируя только путь от корня до изменённого листа; остальные
+// узлы версии разделяют. Узлы считают ссылки атомарно, поэтому версии можно передавать
+// между потоками. MakeTransient() даёт изменяемую копию для пакетных правок: узлы, которыми
+// она владеет единолично, правятся на месте, без копирования пути.
+template <typename T, typename Allocator = std::allocator<T>>
+class PersistentVector {
+    static constexpr uint32_t BITS = 5;
+    static constexpr size_t WIDTH = size_t{1} << BITS;
+    static constexpr size_t MASK = WIDTH - 1;
+
+    struct Node {
+        std::atomic<uint32_t> refs = 1;
+        bool is_leaf = false;
+    };
+
+    struct Inner : Node {
+        Node* children[WIDTH] = {};
+    };
+
+    // Лист дерева всегда заполнен; неполным бывает только хвост
+    struct Leaf : Node {
+        uint32_t count = 0;
+        alignas(T) unsigned char storage[WIDTH * sizeof(T)];
+
+        T* Data() noexcept {
+            return std::launder(reinterpret_cast<T*>(storage));
+        }
+    };
+
+    using InnerAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Inner>;
+    using LeafAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Leaf>;
+
+public:
+    class Transient;
+    class ConstIterator;
+
+    using const_iterator = ConstIterator;
+    using iterator = ConstIterator;
+    using allocator_type = Allocator;
+
+    PersistentVector() = default;
+
+    explicit PersistentVector(const Allocator& alloc) noexcept
+        : alloc_(alloc)
+    {
+    }
+
+    // Строит дерево за O(n), заполняя листья на месте. Если копирование элемента выбросит
+    // исключение, деструктор освобождает уже построенные узлы
+    template <typename VectorAllocator, typename GrowthPolicy, typename StatsPolicy>
+    explicit PersistentVector(const Vector<T, VectorAllocator, GrowthPolicy, StatsPolicy>& v,
+                              const Allocator& alloc = Allocator())
+        : PersistentVector(alloc)
+    {
+        for (const T& value : v) {
+            EmplaceBackInPlace(value);
+        }
+    }
+
+    PersistentVector(const PersistentVector& other) noexcept
+        : alloc_(other.alloc_)
+        , root_(Ref(other.root_))
+        , tail_(static_cast<Leaf*>(Ref(other.tail_)))
+        , size_(other.size_)
+        , shift_(other.shift_)
+    {
+    }
+
+    PersistentVector(PersistentVector&& other) noexcept
+        : alloc_(other.alloc_)
+        , root_(std::exchange(other.root_, nullptr))
+        , tail_(std::exchange(other.tail_, nullptr))
+        , size_(std::exchange(other.size_, 0))
+        , shift_(std::exchange(other.shift_, BITS))
+    {
+    }
+
+    PersistentVector& operator=(const PersistentVector& rhs) noexcept {
+        PersistentVector rhs_copy(rhs);
+        Swap(rhs_copy);
+        return *this;
+    }
+
+    PersistentVector& operator=(PersistentVector&& rhs) noexcept {
+        PersistentVector rhs_moved(std::move(rhs));
+        Swap(rhs_moved);
+        return *this;
+    }
+
+    ~PersistentVector() {
+        Release(root_);
+        Release(tail_);
+    }
+
+    [[nodiscard]] PersistentVector PushBack(T value) const {
+        PersistentVector result(*this);
+        result.EmplaceBackInPlace(std::move(value));
+        return result;
+    }
+
+    [[nodiscard]] PersistentVector Set(size_t index, T value) const {
+        PersistentVector result(*this);
+        result.SetInPlace(index, std::move(value));
+        return result;
+    }
+
+    [[nodiscard]] PersistentVector PopBack() const {
+        PersistentVector result(*this);
+        result.PopBackInPlace();
+        return result;
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return LeafFor(index)->Data()[index & MASK];
+    }
+
+    [[nodiscard]] Transient MakeTransient() const {
+        return Transient(*this);
+    }
+
+    // Копирует элементы в Vector за O(n), по листу за раз
+    template <typename VectorType = Vector<T>>
+    VectorType ToVector() const {
+        VectorType result;
+        result.Reserve(size_);
+        ForEachLeaf([&result](const T* first, size_t count) {
+            result.Append(first, first + count);
+        });
+        return result;
+    }
+
+    void Swap(PersistentVector& other) noexcept {
+        if constexpr (std::allocator_traits<Allocator>::propagate_on_container_swap::value) {
+            std::swap(alloc_, other.alloc_);
+        }
+        std::swap(root_, other.root_);
+        std::swap(tail_, other.tail_);
+        std::swap(size_, other.size_);
+        std::swap(shift_, other.shift_);
+    }
+
+    allocator_type GetAllocator() const noexcept {
+        return alloc_;
+    }
+
+    const_iterator begin() const noexcept { return {this, 0}; }
+    const_iterator end() const noexcept { return {this, size_}; }
+    const_iterator cbegin() const noexcept { return {this, 0}; }
+    const_iterator cend() const noexcept { return {this, size_}; }
+
+    // Изменяемая версия для пакетных правок. Первая правка пути копирует разделённые узлы,
+    // последующие правки того же пути выполняются на месте
+    class Transient {
+    public:
+        explicit Transient(const PersistentVector& base) noexcept
+            : vector_(base)
+        {
+        }
+
+        template <typename... Args>
+        void EmplaceBack(Args&&... args) {
+            vector_.EmplaceBackInPlace(std::forward<Args>(args)...);
+        }
+
+        void PushBack(const T& value) {
+            EmplaceBack(value);
+        }
+
+        void PushBack(T&& value) {
+            EmplaceBack(std::move(value));
+        }
+
+        void Set(size_t index, T value) {
+            vector_.SetInPlace(index, std::move(value));
+        }
+
+        void PopBack() {
+            vector_.PopBackInPlace();
+        }
+
+        size_t Size() const noexcept {
+            return vector_.Size();
+        }
+
+        const T& operator[](size_t index) const noexcept {
+            return vector_[index];
+        }
+
+        // Завершает пакет правок; сам Transient после этого пуст
+        [[nodiscard]] PersistentVector Persistent() && noexcept {
+            return std::move(vector_);
+        }
+
+    private:
+        PersistentVector vector_;
+    };
+
+    // Итератор запоминает текущий лист и спускается по дереву только при переходе в другой лист
+    class ConstIterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        ConstIterator() = default;
+
+        ConstIterator(const PersistentVector* owner, size_t index) noexcept
+            : owner_(owner)
+            , index_(index)
+        {
+        }
+
+        reference operator*() const noexcept {
+            const size_t chunk_begin = index_ & ~MASK;
+            if (chunk_ == nullptr || chunk_begin != chunk_begin_) {
+                chunk_ = owner_->LeafFor(index_)->Data();
+                chunk_begin_ = chunk_begin;
+            }
+            return chunk_[index_ & MASK];
+        }
+        pointer operator->() const noexcept { return &**this; }
+        reference operator[](difference_type n) const noexcept { return *(*this + n); }
+
+        ConstIterator& operator++() noexcept { ++index_; return *this; }
+        ConstIterator operator++(int) noexcept { ConstIterator copy(*this); ++index_; return copy; }
+        ConstIterator& operator--() noexcept { --index_; return *this; }
+        ConstIterator operator--(int) noexcept { ConstIterator copy(*this); --index_; return copy; }
+        ConstIterator& operator+=(difference_type n) noexcept { index_ += n; return *this; }
+        ConstIterator& operator-=(difference_type n) noexcept { index_ -= n; return *this; }
+
+        friend ConstIterator operator+(ConstIterator it, difference_type n) noexcept { return it += n; }
+        friend ConstIterator operator+(difference_type n, ConstIterator it) noexcept { return it += n; }
+        friend ConstIterator operator-(ConstIterator it, difference_type n) noexcept { return it -= n; }
+        friend difference_type operator-(const ConstIterator& lhs, const ConstIterator& rhs) noexcept {
+            return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+        }
+
+        friend bool operator==(const ConstIterator& lhs, const ConstIterator& rhs) noexcept {
+            return lhs.index_ == rhs.index_;
+        }
+        friend auto operator<=>(const ConstIterator& lhs, const ConstIterator& rhs) noexcept {
+            return lhs.index_ <=> rhs.index_;
+        }
+
+    private:
+        const PersistentVector* owner_ = nullptr;
+        size_t index_ = 0;
+        mutable const T* chunk_ = nullptr;
+        mutable size_t chunk_begin_ = 0;
+    };
+
+private:
+    [[no_unique_address]] Allocator alloc_;
+    // Корень отсутствует, пока все элементы помещаются в хвост
+    Node* root_ = nullptr;
+    Leaf* tail_ = nullptr;
+    size_t size_ = 0;
+    // Сдвиг индекса для выбора потомка корня; листья находятся на уровне 0
+    uint32_t shift_ = BITS;
+
+    // Индекс первого элемента хвоста
+    size_t TailOffset() const noexcept {
+        return size_ < WIDTH ? 0 : ((size_ - 1) >> BITS) << BITS;
+    }
+
+    Leaf* LeafFor(size_t index) const noexcept {
+        if (index >= TailOffset()) {
+            return tail_;
+        }
+        Node* node = root_;
+        for (uint32_t level = shift_; level > 0; level -= BITS) {
+            node = static_cast<Inner*>(node)->children[(index >> level) & MASK];
+        }
+        return static_cast<Leaf*>(node);
+    }
+
+    template <typename Visitor>
+    void ForEachLeaf(Visitor visitor) const {
+        if (root_ != nullptr) {
+            ForEachLeaf(root_, shift_, visitor);
+        }
+        if (tail_ != nullptr) {
+            visitor(tail_->Data(), static_cast<size_t>(tail_->count));
+        }
+    }
+
+    template <typename Visitor>
+    static void ForEachLeaf(Node* node, uint32_t level, Visitor& visitor) {
+        if (level == 0) {
+            Leaf* leaf = static_cast<Leaf*>(node);
+            visitor(leaf->Data(), static_cast<size_t>(leaf->count));
+            return;
+        }
+        for (Node* child : static_cast<Inner*>(node)->children) {
+            if (child == nullptr) {
+                break;
+            }
+            ForEachLeaf(child, level - BITS, visitor);
+        }
+    }
+
+    /*----- Правки на месте: разделённые узлы копируются, единоличные изменяются -----*/
+
+    template <typename... Args>
+    void EmplaceBackInPlace(Args&&... args) {
+        if (tail_ != nullptr && tail_->count == WIDTH) {
+            // Новый хвост создаётся до переноса старого в дерево: при исключении вектор не меняется
+            Leaf* new_tail = NewLeaf();
+            try {
+                new (new_tail->Data()) T(std::forward<Args>(args)...);
+            } catch (...) {
+                DeallocateLeaf(new_tail);
+                throw;
+            }
+            new_tail->count = 1;
+            PushTail(new_tail);
+            ++size_;
+            return;
+        }
+        if (tail_ == nullptr) {
+            tail_ = NewLeaf();
+        }
+        // Аргументы могут ссылаться на элементы хвоста: при копировании хвоста старый остаётся жив,
+        // потому что разделён с другой версией
+        Leaf* tail = UniqueLeaf(tail_);
+        new (tail->Data() + tail->count) T(std::forward<Args>(args)...);
+        ++tail->count;
+        ++size_;
+    }
+
+    void SetInPlace(size_t index, T value) {
+        assert(index < size_);
+        if (index >= TailOffset()) {
+            UniqueLeaf(tail_)->Data()[index & MASK] = std::move(value);
+            return;
+        }
+        Node** slot = &root_;
+        for (uint32_t level = shift_; level > 0; level -= BITS) {
+            Inner* node = UniqueInner(*slot);
+            slot = &node->children[(index >> level) & MASK];
+        }
+        UniqueLeaf(*slot)->Data()[index & MASK] = std::move(value);
+    }
+
+    void PopBackInPlace() {
+        assert(size_ != 0);
+        if (tail_->count > 1 || size_ == 1) {
+            Leaf* tail = UniqueLeaf(tail_);
+            --tail->count;
+            std::destroy_at(tail->Data() + tail->count);
+            --size_;
+            if (size_ == 0) {
+                Release(tail_);
+                tail_ = nullptr;
+            }
+            return;
+        }
+        // Хвост опустел: его место занимает последний лист дерева
+        Leaf* new_tail = static_cast<Leaf*>(Ref(LeafFor(size_ - 2)));
+        bool root_emptied = false;
+        try {
+            root_emptied = PopTail(root_, shift_);
+        } catch (...) {
+            Release(new_tail);
+            throw;
+        }
+        if (root_emptied) {
+            Release(root_);
+            root_ = nullptr;
+        }
+        else if (shift_ > BITS && static_cast<Inner*>(root_)->children[1] == nullptr) {
+            Node* new_root = Ref(static_cast<Inner*>(root_)->children[0]);
+            Release(root_);
+            root_ = new_root;
+            shift_ -= BITS;
+        }
+        Release(tail_);
+        tail_ = new_tail;
+        --size_;
+    }
+
+    // Переносит полный хвост в дерево и делает new_tail хвостом
+    void PushTail(Leaf* new_tail) {
+        Node* full_tail = tail_;
+        if (root_ != nullptr && (size_ >> BITS) > (size_t{1} << shift_)) {
+            // Корень заполнен: дерево растёт на один уровень
+            Inner* new_root = NewInner();
+            new_root->children[0] = root_;
+            try {
+                new_root->children[1] = NewPath(shift_, full_tail);
+            } catch (...) {
+                new_root->children[0] = nullptr;
+                DeallocateInner(new_root);
+                Release(new_tail);
+                throw;
+            }
+            root_ = new_root;
+            shift_ += BITS;
+        }
+        else {
+            try {
+                PushTailInto(root_, shift_, full_tail);
+            } catch (...) {
+                Release(new_tail);
+                throw;
+            }
+        }
+        tail_ = new_tail;
+    }
+
+    void PushTailInto(Node*& slot, uint32_t level, Node* full_tail) {
+        Inner* node = slot == nullptr ? static_cast<Inner*>(slot = NewInner()) : UniqueInner(slot);
+        Node*& child = node->children[((size_ - 1) >> level) & MASK];
+        if (level == BITS) {
+            child = full_tail;
+        }
+        else if (child != nullptr) {
+            PushTailInto(child, level - BITS, full_tail);
+        }
+        else {
+            child = NewPath(level - BITS, full_tail);
+        }
+    }
+
+    Node* NewPath(uint32_t level, Node* node) {
+        if (level == 0) {
+            return node;
+        }
+        Inner* inner = NewInner();
+        try {
+            inner->children[0] = NewPath(level - BITS, node);
+        } catch (...) {
+            DeallocateInner(inner);
+            throw;
+        }
+        return inner;
+    }
+
+    // Удаляет из дерева последний лист. Возвращает true, если узел slot опустел
+    bool PopTail(Node*& slot, uint32_t level) {
+        Inner* node = UniqueInner(slot);
+        const size_t child_index = ((size_ - 2) >> level) & MASK;
+        Node*& child = node->children[child_index];
+        if (level > BITS && !PopTail(child, level - BITS)) {
+            return false;
+        }
+        Release(child);
+        child = nullptr;
+        return child_index == 0;
+    }
+
+    /*----- Узлы -----*/
+
+    static Node* Ref(Node* node) noexcept {
+        if (node != nullptr) {
+            node->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+        return node;
+    }
+
+    void Release(Node* node) noexcept {
+        if (node == nullptr || node->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+        if (node->is_leaf) {
+            Leaf* leaf = static_cast<Leaf*>(node);
+            std::destroy_n(leaf->Data(), leaf->count);
+            DeallocateLeaf(leaf);
+        }
+        else {
+            Inner* inner = static_cast<Inner*>(node);
+            for (Node* child : inner->children) {
+                Release(child);
+            }
+            DeallocateInner(inner);
+        }
+    }
+
+    // Если узел разделён с другими версиями, заменяет его в slot собственной копией
+    template <typename Slot>
+    Leaf* UniqueLeaf(Slot& slot) {
+        Leaf* leaf = static_cast<Leaf*>(slot);
+        if (leaf->refs.load(std::memory_order_acquire) == 1) {
+            return leaf;
+        }
+        Leaf* copy = NewLeaf();
+        try {
+            std::uninitialized_copy_n(leaf->Data(), leaf->count, copy->Data());
+        } catch (...) {
+            DeallocateLeaf(copy);
+            throw;
+        }
+        copy->count = leaf->count;
+        Release(leaf);
+        slot = copy;
+        return copy;
+    }
+
+    Inner* UniqueInner(Node*& slot) {
+        Inner* node = static_cast<Inner*>(slot);
+        if (node->refs.load(std::memory_order_acquire) == 1) {
+            return node;
+        }
+        Inner* copy = NewInner();
+        for (size_t i = 0; i != WIDTH; ++i) {
+            copy->children[i] = Ref(node->children[i]);
+        }
+        Release(node);
+        slot = copy;
+        return copy;
+    }
+
+    Leaf* NewLeaf() {
+        LeafAllocator alloc(alloc_);
+        Leaf* leaf = std::allocator_traits<LeafAllocator>::allocate(alloc, 1);
+        new (leaf) Leaf();
+        leaf->is_leaf = true;
+        return leaf;
+    }
+
+    Inner* NewInner() {
+        InnerAllocator alloc(alloc_);
+        Inner* inner = std::allocator_traits<InnerAllocator>::allocate(alloc, 1);
+        return new (inner) Inner();
+    }
+
+    void DeallocateLeaf(Leaf* leaf) noexcept {
+        LeafAllocator alloc(alloc_);
+        std::destroy_at(leaf);
+        std::allocator_traits<LeafAllocator>::deallocate(alloc, leaf, 1);
+    }
+
+    void DeallocateInner(Inner* inner) noexcept {
+        InnerAllocator alloc(alloc_);
+        std::destroy_at(inner);
+        std::allocator_traits<InnerAllocator>::deallocate(alloc, inner, 1);
+    }
+};
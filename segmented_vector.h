@@ -0,0 +1,276 @@
+#pragma once
+#include "vector.h"
+
+#include <bit>
+
+// Число элементов в сегменте по умолчанию: степень двойки, при которой сегмент занимает около 4 КиБ
+template <typename T>
+inline constexpr size_t DEFAULT_SEGMENT_BITS = std::bit_width(std::max<size_t>(4096 / sizeof(T), 1)) - 1;
+
+// Вектор из сегментов RawMemory по 2^SegmentBits элементов. Рост добавляет новый сегмент
+// и никогда не переносит элементы, поэтому указатели и ссылки на них остаются действительными,
+// а худшее время добавления ограничено одним выделением памяти. Перевыделяется только таблица
+// сегментов, которая в 2^SegmentBits раз короче самого вектора. Индекс переводится
+// в номер сегмента и смещение сдвигом и маской. Интерфейс повторяет Vector.
+template <typename T, size_t SegmentBits = DEFAULT_SEGMENT_BITS<T>, typename Allocator = std::allocator<T>>
+class SegmentedVector {
+    using Segment = RawMemory<T, Allocator>;
+    using SegmentTable = Vector<Segment, typename std::allocator_traits<Allocator>::template rebind_alloc<Segment>>;
+
+public:
+    static constexpr size_t SEGMENT_SIZE = size_t{1} << SegmentBits;
+    static constexpr size_t SEGMENT_MASK = SEGMENT_SIZE - 1;
+
+    template <bool IsConst>
+    class Iterator;
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+    using allocator_type = Allocator;
+
+    SegmentedVector() = default;
+
+    explicit SegmentedVector(const Allocator& alloc) noexcept
+        : segments_(typename SegmentTable::allocator_type(alloc))
+    {
+    }
+
+    explicit SegmentedVector(size_t size, const Allocator& alloc = Allocator())
+        : SegmentedVector(alloc)
+    {
+        Resize(size);
+    }
+
+    SegmentedVector(const SegmentedVector& other)
+        : SegmentedVector(
+            std::allocator_traits<Allocator>::select_on_container_copy_construction(other.GetAllocator()))
+    {
+        Reserve(other.size_);
+        for (const T& value : other) {
+            EmplaceBack(value);
+        }
+    }
+
+    SegmentedVector(SegmentedVector&& other) noexcept
+        : segments_(std::move(other.segments_))
+        , size_(std::exchange(other.size_, 0))
+    {
+    }
+
+    SegmentedVector& operator=(const SegmentedVector& rhs) {
+        if (this != &rhs) {
+            SegmentedVector rhs_copy(rhs);
+            Swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    SegmentedVector& operator=(SegmentedVector&& rhs) noexcept {
+        SegmentedVector rhs_moved(std::move(rhs));
+        Swap(rhs_moved);
+        return *this;
+    }
+
+    ~SegmentedVector() {
+        Clear();
+    }
+
+    void Resize(size_t new_size) {
+        while (size_ > new_size) {
+            PopBack();
+        }
+        Reserve(new_size);
+        while (size_ < new_size) {
+            EmplaceBack();
+        }
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    void PopBack() noexcept {
+        if (size_ != 0) {
+            --size_;
+            std::destroy_at(SlotAt(size_));
+        }
+    }
+
+    // Если конструктор выбросит исключение, вектор не изменится; выделенный сегмент сохранится как запас
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        if (size_ == Capacity()) {
+            AddSegment();
+        }
+        T* slot = new (SlotAt(size_)) T(std::forward<Args>(args)...);
+        ++size_;
+        return *slot;
+    }
+
+    template <typename... Args>
+    iterator Emplace(const_iterator pos, Args&&... args) {
+        const size_t i_pos = pos - cbegin();
+        if (i_pos == size_) {
+            EmplaceBack(std::forward<Args>(args)...);
+            return begin() + i_pos;
+        }
+        // Значение создаётся до сдвига и защищает от аргументов, ссылающихся на сдвигаемые элементы
+        T value(std::forward<Args>(args)...);
+        EmplaceBack(std::move((*this)[size_ - 1]));
+        std::move_backward(begin() + i_pos, end() - 2, end() - 1);
+        (*this)[i_pos] = std::move(value);
+        return begin() + i_pos;
+    }
+
+    iterator Insert(const_iterator pos, const T& value) {
+        return Emplace(pos, value);
+    }
+
+    iterator Insert(const_iterator pos, T&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    iterator Erase(const_iterator pos) noexcept(std::is_nothrow_move_assignable_v<T>) {
+        const size_t i_pos = pos - cbegin();
+        std::move(begin() + i_pos + 1, end(), begin() + i_pos);
+        PopBack();
+        return begin() + i_pos;
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return segments_.Size() * SEGMENT_SIZE;
+    }
+
+    // Выделяет сегменты, пока ёмкость меньше new_capacity; элементы не переносятся
+    void Reserve(size_t new_capacity) {
+        const size_t num_segments = (new_capacity + SEGMENT_MASK) >> SegmentBits;
+        segments_.Reserve(num_segments);
+        while (segments_.Size() < num_segments) {
+            AddSegment();
+        }
+    }
+
+    // Освобождает сегменты, в которых не осталось элементов
+    void ShrinkToFit() {
+        const size_t num_segments = (size_ + SEGMENT_MASK) >> SegmentBits;
+        while (segments_.Size() > num_segments) {
+            segments_.PopBack();
+        }
+        segments_.ShrinkToFit();
+    }
+
+    // Удаляет все элементы, сохраняя сегменты
+    void Clear() noexcept {
+        for (size_t first = 0; first < size_; first += SEGMENT_SIZE) {
+            std::destroy_n(segments_[first >> SegmentBits].GetAddress(), std::min(SEGMENT_SIZE, size_ - first));
+        }
+        size_ = 0;
+    }
+
+    // Удаляет все элементы и возвращает все сегменты аллокатору
+    void ReleaseMemory() noexcept {
+        Clear();
+        segments_.ReleaseMemory();
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return *SlotAt(index);
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<SegmentedVector&>(*this)[index];
+    }
+
+    void Swap(SegmentedVector& other) noexcept {
+        segments_.Swap(other.segments_);
+        std::swap(size_, other.size_);
+    }
+
+    allocator_type GetAllocator() const noexcept {
+        return allocator_type(segments_.GetAllocator());
+    }
+
+    iterator begin() noexcept { return {this, 0}; }
+    iterator end() noexcept { return {this, size_}; }
+    const_iterator begin() const noexcept { return {this, 0}; }
+    const_iterator end() const noexcept { return {this, size_}; }
+    const_iterator cbegin() const noexcept { return {this, 0}; }
+    const_iterator cend() const noexcept { return {this, size_}; }
+
+    // Итератор произвольного доступа; хранит индекс и находит элемент сдвигом и маской
+    template <bool IsConst>
+    class Iterator {
+        using Owner = std::conditional_t<IsConst, const SegmentedVector, SegmentedVector>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<IsConst, const T*, T*>;
+        using reference = std::conditional_t<IsConst, const T&, T&>;
+
+        Iterator() = default;
+
+        Iterator(Owner* owner, size_t index) noexcept
+            : owner_(owner)
+            , index_(index)
+        {
+        }
+
+        // Неконстантный итератор неявно преобразуется в константный
+        operator Iterator<true>() const noexcept {
+            return {owner_, index_};
+        }
+
+        reference operator*() const noexcept { return *const_cast<SegmentedVector*>(owner_)->SlotAt(index_); }
+        pointer operator->() const noexcept { return const_cast<SegmentedVector*>(owner_)->SlotAt(index_); }
+        reference operator[](difference_type n) const noexcept { return *(*this + n); }
+
+        Iterator& operator++() noexcept { ++index_; return *this; }
+        Iterator operator++(int) noexcept { Iterator copy(*this); ++index_; return copy; }
+        Iterator& operator--() noexcept { --index_; return *this; }
+        Iterator operator--(int) noexcept { Iterator copy(*this); --index_; return copy; }
+        Iterator& operator+=(difference_type n) noexcept { index_ += n; return *this; }
+        Iterator& operator-=(difference_type n) noexcept { index_ -= n; return *this; }
+
+        friend Iterator operator+(Iterator it, difference_type n) noexcept { return it += n; }
+        friend Iterator operator+(difference_type n, Iterator it) noexcept { return it += n; }
+        friend Iterator operator-(Iterator it, difference_type n) noexcept { return it -= n; }
+        friend difference_type operator-(const Iterator& lhs, const Iterator& rhs) noexcept {
+            return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+        }
+
+        friend bool operator==(const Iterator& lhs, const Iterator& rhs) noexcept {
+            return lhs.index_ == rhs.index_;
+        }
+        friend auto operator<=>(const Iterator& lhs, const Iterator& rhs) noexcept {
+            return lhs.index_ <=> rhs.index_;
+        }
+
+    private:
+        Owner* owner_ = nullptr;
+        size_t index_ = 0;
+    };
+
+private:
+    SegmentTable segments_;
+    size_t size_ = 0;
+
+    // Адрес ячейки index в пределах ёмкости
+    T* SlotAt(size_t index) noexcept {
+        return segments_[index >> SegmentBits].GetAddress() + (index & SEGMENT_MASK);
+    }
+
+    void AddSegment() {
+        segments_.EmplaceBack(SEGMENT_SIZE, GetAllocator());
+    }
+};
@@ -0,0 +1,346 @@
+#pragma once
+#include "vector.h"
+
+// Вектор, хранящий до N элементов прямо в объекте и переходящий в динамическую
+// память RawMemory только при переполнении встроенного буфера.
+// Интерфейс повторяет Vector.
+template <typename T, size_t N, typename Allocator = std::allocator<T>>
+class SmallVector {
+    static_assert(N > 0, "Inline capacity must be positive");
+
+public:
+    using iterator = T*;
+    using const_iterator = const T*;
+    using allocator_type = Allocator;
+
+    SmallVector() = default;
+
+    explicit SmallVector(const Allocator& alloc) noexcept
+        : heap_(alloc)
+    {
+    }
+
+    explicit SmallVector(size_t size, const Allocator& alloc = Allocator())
+        : heap_(alloc)
+    {
+        Reserve(size);
+        std::uninitialized_value_construct_n(Data(), size);
+        size_ = size;
+    }
+
+    SmallVector(const SmallVector& other)
+        : heap_(std::allocator_traits<Allocator>::select_on_container_copy_construction(other.GetAllocator()))
+    {
+        Reserve(other.size_);
+        std::uninitialized_copy_n(other.Data(), other.size_, Data());
+        size_ = other.size_;
+    }
+
+    // Динамический буфер забирается целиком, а встроенные элементы перемещаются по одному
+    SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+        : heap_(other.GetAllocator())
+    {
+        if (other.IsInline()) {
+            std::uninitialized_move_n(other.Data(), other.size_, Data());
+            std::destroy_n(other.Data(), other.size_);
+        }
+        else {
+            heap_.Swap(other.heap_);
+        }
+        size_ = std::exchange(other.size_, 0);
+    }
+
+    // Аллокатор заменяется аллокатором rhs, только если этого требует propagate_on_container_copy_assignment.
+    // Иначе элементы копируются в память этого вектора
+    SmallVector& operator=(const SmallVector& rhs) {
+        if (this != &rhs) {
+            if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+                if (GetAllocator() != rhs.GetAllocator()) {
+                    // Память освобождается старым аллокатором; при исключении вектор остаётся пустым
+                    std::destroy_n(Data(), size_);
+                    size_ = 0;
+                    heap_.ResetAllocator(rhs.GetAllocator());
+                }
+            }
+            AssignFrom(rhs.Data(), rhs.size_, [](const T& value) -> const T& {
+                return value;
+            });
+        }
+        return *this;
+    }
+
+    // Буфер rhs забирается, только если аллокатор распространяется при перемещении или аллокаторы равны.
+    // Иначе элементы перемещаются по одному в память этого вектора
+    SmallVector& operator=(SmallVector&& rhs) noexcept((AllocTraits::propagate_on_container_move_assignment::value
+                                                        || AllocTraits::is_always_equal::value)
+                                                       && std::is_nothrow_move_constructible_v<T>) {
+        if (this == &rhs) {
+            return *this;
+        }
+        if constexpr (!AllocTraits::propagate_on_container_move_assignment::value
+                      && !AllocTraits::is_always_equal::value) {
+            if (GetAllocator() != rhs.GetAllocator()) {
+                AssignFrom(rhs.Data(), rhs.size_, [](T& value) -> T&& {
+                    return std::move(value);
+                });
+                return *this;
+            }
+        }
+        std::destroy_n(Data(), size_);
+        size_ = 0;
+        if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+            heap_ = RawMemory<T, Allocator>(rhs.GetAllocator());
+        }
+        else {
+            RawMemory<T, Allocator> empty(GetAllocator());
+            heap_.Swap(empty);
+        }
+        if (rhs.IsInline()) {
+            std::uninitialized_move_n(rhs.Data(), rhs.size_, Data());
+            std::destroy_n(rhs.Data(), rhs.size_);
+        }
+        else {
+            heap_.Swap(rhs.heap_);
+        }
+        size_ = std::exchange(rhs.size_, 0);
+        return *this;
+    }
+
+    ~SmallVector() {
+        std::destroy_n(Data(), size_);
+    }
+
+    void Resize(size_t new_size) {
+        if (new_size < size_) {
+            std::destroy_n(Data() + new_size, size_ - new_size);
+            size_ = new_size;
+            return;
+        }
+        Reserve(new_size);
+        std::uninitialized_value_construct_n(Data() + size_, new_size - size_);
+        size_ = new_size;
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    void PopBack() noexcept {
+        if (size_ != 0) {
+            --size_;
+            std::destroy_at(Data() + size_);
+        }
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        return *Emplace(cend(), std::forward<Args>(args)...);
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return IsInline() ? N : heap_.Capacity();
+    }
+
+    // Возвращает true, пока элементы хранятся во встроенном буфере
+    bool IsInline() const noexcept {
+        return heap_.GetAddress() == nullptr;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<SmallVector&>(*this)[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return Data()[index];
+    }
+
+    // Обмен учитывает все сочетания встроенного и динамического хранения
+    void Swap(SmallVector& other) noexcept(std::is_nothrow_move_constructible_v<T>
+                                           && std::is_nothrow_swappable_v<T>) {
+        if (!IsInline() && !other.IsInline()) {
+            heap_.Swap(other.heap_);
+        }
+        else if (IsInline() && other.IsInline()) {
+            SmallVector& larger = size_ >= other.size_ ? *this : other;
+            SmallVector& smaller = size_ >= other.size_ ? other : *this;
+            using std::swap;
+            for (size_t i = 0; i != smaller.size_; ++i) {
+                swap(larger.Data()[i], smaller.Data()[i]);
+            }
+            size_t n_extra = larger.size_ - smaller.size_;
+            std::uninitialized_move_n(larger.Data() + smaller.size_, n_extra, smaller.Data() + smaller.size_);
+            std::destroy_n(larger.Data() + smaller.size_, n_extra);
+        }
+        else {
+            SmallVector& on_heap = IsInline() ? other : *this;
+            SmallVector& in_place = IsInline() ? *this : other;
+            // Встроенный буфер владельца динамической памяти свободен и принимает элементы партнёра
+            std::uninitialized_move_n(in_place.Data(), in_place.size_, on_heap.InlineData());
+            std::destroy_n(in_place.Data(), in_place.size_);
+            in_place.heap_.Swap(on_heap.heap_);
+        }
+        std::swap(size_, other.size_);
+    }
+
+    allocator_type GetAllocator() const noexcept {
+        return heap_.GetAllocator();
+    }
+
+    void Reserve(size_t new_capacity) {
+        if (new_capacity <= Capacity()) {
+            return;
+        }
+        RawMemory<T, Allocator> new_data(new_capacity, heap_.GetAllocator());
+        TransferTo(Data(), size_, new_data.GetAddress());
+        heap_.Swap(new_data);
+    }
+
+    template <typename... Args>
+    iterator Emplace(const_iterator pos, Args&&... args) {
+        size_t i_pos = std::distance(cbegin(), pos);
+        if (size_ < Capacity()) {
+            if (i_pos == size_) {
+                new (end()) T(std::forward<Args>(args)...);
+            }
+            else {
+                // Временный объект защищает от аргументов, ссылающихся на элементы самого вектора
+                T value(std::forward<Args>(args)...);
+                new (end()) T(std::move(*(end() - 1)));
+                // Новый последний элемент учитывается сразу, чтобы не потерять его при исключении в сдвиге
+                ++size_;
+                std::move_backward(begin() + i_pos, end() - 2, end() - 1);
+                Data()[i_pos] = std::move(value);
+                return begin() + i_pos;
+            }
+        }
+        else {
+            RawMemory<T, Allocator> new_data(Capacity() * 2, heap_.GetAllocator());
+            new (new_data.GetAddress() + i_pos) T(std::forward<Args>(args)...);
+            if constexpr (IsTriviallyRelocatable<T>::value) {
+                TransferTo(Data(), i_pos, new_data.GetAddress());
+                TransferTo(Data() + i_pos, size_ - i_pos, new_data.GetAddress() + i_pos + 1);
+            }
+            else {
+                try {
+                    MoveOrCopyN(Data(), i_pos, new_data.GetAddress());
+                } catch (...) {
+                    std::destroy_at(new_data.GetAddress() + i_pos);
+                    throw;
+                }
+                try {
+                    MoveOrCopyN(Data() + i_pos, size_ - i_pos, new_data.GetAddress() + i_pos + 1);
+                } catch (...) {
+                    std::destroy_n(new_data.GetAddress(), i_pos + 1);
+                    throw;
+                }
+                std::destroy_n(Data(), size_);
+            }
+            heap_.Swap(new_data);
+        }
+        ++size_;
+        return begin() + i_pos;
+    }
+
+    iterator Erase(const_iterator pos) noexcept(std::is_nothrow_move_assignable_v<T>) {
+        size_t i_pos = std::distance(cbegin(), pos);
+        std::move(begin() + i_pos + 1, end(), begin() + i_pos);
+        PopBack();
+        return begin() + i_pos;
+    }
+
+    iterator Insert(const_iterator pos, const T& value) {
+        return Emplace(pos, value);
+    }
+    iterator Insert(const_iterator pos, T&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    iterator begin() noexcept { return Data(); }
+    iterator end() noexcept { return Data() + size_; }
+    const_iterator begin() const noexcept { return Data(); }
+    const_iterator end() const noexcept { return Data() + size_; }
+    const_iterator cbegin() const noexcept { return Data(); }
+    const_iterator cend() const noexcept { return Data() + size_; }
+
+private:
+    using AllocTraits = std::allocator_traits<Allocator>;
+
+    RawMemory<T, Allocator> heap_;
+    size_t size_ = 0;
+    alignas(T) unsigned char inline_[N * sizeof(T)];
+
+    T* InlineData() noexcept {
+        return reinterpret_cast<T*>(inline_);
+    }
+
+    T* Data() noexcept {
+        return IsInline() ? InlineData() : heap_.GetAddress();
+    }
+
+    const T* Data() const noexcept {
+        return const_cast<SmallVector&>(*this).Data();
+    }
+
+    // Присваивает вектору значения [src, src + count), сохраняя его аллокатор. get преобразует
+    // исходный элемент в ссылку нужной категории (копирование или перемещение). Если ёмкости
+    // не хватает, элементы создаются в новом буфере и при исключении вектор не меняется
+    template <typename U, typename Getter>
+    void AssignFrom(U* src, size_t count, Getter get) {
+        if (count > Capacity()) {
+            SmallVector result(GetAllocator());
+            result.Reserve(count);
+            for (; result.size_ != count; ++result.size_) {
+                new (result.Data() + result.size_) T(get(src[result.size_]));
+            }
+            Swap(result);
+            return;
+        }
+        const size_t n_to_assign = std::min(size_, count);
+        for (size_t i = 0; i != n_to_assign; ++i) {
+            Data()[i] = get(src[i]);
+        }
+        if (count > size_) {
+            for (; size_ != count; ++size_) {
+                new (Data() + size_) T(get(src[size_]));
+            }
+        }
+        else {
+            std::destroy_n(Data() + count, size_ - count);
+            size_ = count;
+        }
+    }
+
+    // Создаёт в неинициализированной памяти to копии n элементов, перемещая их,
+    // если перемещение не выбрасывает исключений
+    static void MoveOrCopyN(T* from, size_t n, T* to) {
+        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+            std::uninitialized_move_n(from, n, to);
+        }
+        else {
+            std::uninitialized_copy_n(from, n, to);
+        }
+    }
+
+    // Переносит n элементов в неинициализированную память to и разрушает исходные.
+    // Если копирование выбрасывает исключение, исходные элементы не меняются
+    static void TransferTo(T* from, size_t n, T* to) {
+        if constexpr (IsTriviallyRelocatable<T>::value) {
+            if (n != 0) {
+                std::memcpy(static_cast<void*>(to), static_cast<const void*>(from), n * sizeof(T));
+            }
+        }
+        else {
+            MoveOrCopyN(from, n, to);
+            std::destroy_n(from, n);
+        }
+    }
+};
@@ -0,0 +1,300 @@
+#pragma once
+#include "vector.h"
+
+#include <span>
+#include <tuple>
+
+// Вектор записей, хранящий каждое поле в отдельном массиве (structure of arrays).
+// Проход по одному столбцу читает только его байты и легко векторизуется компилятором.
+// Строки доступны через прокси-ссылку std::tuple<Fields&...> и итератор по строкам.
+// Поля должны перемещаться без исключений: перенос столбцов при росте не откатывается.
+template <typename... Fields>
+class SoAVector {
+    static_assert(sizeof...(Fields) > 0, "At least one field is required");
+    static_assert((std::is_nothrow_move_constructible_v<Fields> && ...),
+                  "Fields must be nothrow move constructible");
+
+    template <size_t I>
+    using FieldType = std::tuple_element_t<I, std::tuple<Fields...>>;
+
+    static constexpr size_t ROW_SIZE = (sizeof(Fields) + ...);
+    using Indices = std::index_sequence_for<Fields...>;
+
+public:
+    using value_type = std::tuple<Fields...>;
+    using reference = std::tuple<Fields&...>;
+    using const_reference = std::tuple<const Fields&...>;
+
+    template <bool IsConst>
+    class RowIterator;
+
+    using iterator = RowIterator<false>;
+    using const_iterator = RowIterator<true>;
+
+    SoAVector() = default;
+
+    // Делегирование гарантирует вызов деструктора, если конструктор поля выбросит исключение
+    explicit SoAVector(size_t size)
+        : SoAVector()
+    {
+        Resize(size);
+    }
+
+    SoAVector(const SoAVector& other)
+        : SoAVector()
+    {
+        Reserve(other.size_);
+        for (size_t i = 0; i != other.size_; ++i) {
+            std::apply(
+                [this](const Fields&... fields) {
+                    EmplaceBack(fields...);
+                },
+                other[i]);
+        }
+    }
+
+    SoAVector(SoAVector&& other) noexcept
+        : columns_(std::move(other.columns_))
+        , size_(std::exchange(other.size_, 0))
+        , capacity_(std::exchange(other.capacity_, 0))
+    {
+    }
+
+    SoAVector& operator=(const SoAVector& rhs) {
+        if (this != &rhs) {
+            SoAVector rhs_copy(rhs);
+            Swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    SoAVector& operator=(SoAVector&& rhs) noexcept {
+        SoAVector rhs_moved(std::move(rhs));
+        Swap(rhs_moved);
+        return *this;
+    }
+
+    ~SoAVector() {
+        Clear();
+    }
+
+    // Добавляет строку; если конструктор какого-либо поля выбросит исключение, вектор не изменится
+    template <typename... Args>
+    reference EmplaceBack(Args&&... args) {
+        static_assert(sizeof...(Args) == sizeof...(Fields), "One argument per field is expected");
+        if (size_ == capacity_) {
+            // Строка создаётся в новых столбцах до переноса старых: аргументы могут ссылаться на поля вектора
+            const size_t new_capacity = DoublingGrowth::NextCapacity(size_, ROW_SIZE);
+            std::tuple<RawMemory<Fields>...> new_columns{RawMemory<Fields>(new_capacity)...};
+            ConstructRow(new_columns, Indices{}, size_, std::forward<Args>(args)...);
+            TransferColumns(new_columns, Indices{});
+            columns_.swap(new_columns);
+            capacity_ = new_capacity;
+        }
+        else {
+            ConstructRow(columns_, Indices{}, size_, std::forward<Args>(args)...);
+        }
+        ++size_;
+        return (*this)[size_ - 1];
+    }
+
+    void PopBack() noexcept {
+        if (size_ != 0) {
+            --size_;
+            DestroyRows(size_, 1, Indices{});
+        }
+    }
+
+    void Resize(size_t new_size) {
+        if (new_size < size_) {
+            DestroyRows(new_size, size_ - new_size, Indices{});
+            size_ = new_size;
+            return;
+        }
+        Reserve(new_size);
+        while (size_ != new_size) {
+            EmplaceBack(Fields()...);
+        }
+    }
+
+    void Clear() noexcept {
+        DestroyRows(0, size_, Indices{});
+        size_ = 0;
+    }
+
+    void Reserve(size_t new_capacity) {
+        if (new_capacity <= capacity_) {
+            return;
+        }
+        std::tuple<RawMemory<Fields>...> new_columns{RawMemory<Fields>(new_capacity)...};
+        TransferColumns(new_columns, Indices{});
+        columns_.swap(new_columns);
+        capacity_ = new_capacity;
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return capacity_;
+    }
+
+    void Swap(SoAVector& other) noexcept {
+        std::apply(
+            [&other](auto&... columns) {
+                std::apply(
+                    [&columns...](auto&... other_columns) {
+                        (columns.Swap(other_columns), ...);
+                    },
+                    other.columns_);
+            },
+            columns_);
+        std::swap(size_, other.size_);
+        std::swap(capacity_, other.capacity_);
+    }
+
+    // Столбец I как непрерывный массив из Size() элементов
+    template <size_t I>
+    std::span<FieldType<I>> Column() noexcept {
+        return {std::get<I>(columns_).GetAddress(), size_};
+    }
+
+    template <size_t I>
+    std::span<const FieldType<I>> Column() const noexcept {
+        return {std::get<I>(columns_).GetAddress(), size_};
+    }
+
+    template <size_t I>
+    FieldType<I>& Get(size_t index) noexcept {
+        assert(index < size_);
+        return std::get<I>(columns_)[index];
+    }
+
+    template <size_t I>
+    const FieldType<I>& Get(size_t index) const noexcept {
+        assert(index < size_);
+        return std::get<I>(columns_)[index];
+    }
+
+    reference operator[](size_t index) noexcept {
+        assert(index < size_);
+        return Row<reference>(index, Indices{});
+    }
+
+    const_reference operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return const_cast<SoAVector&>(*this).template Row<const_reference>(index, Indices{});
+    }
+
+    iterator begin() noexcept { return {this, 0}; }
+    iterator end() noexcept { return {this, size_}; }
+    const_iterator begin() const noexcept { return {this, 0}; }
+    const_iterator end() const noexcept { return {this, size_}; }
+    const_iterator cbegin() const noexcept { return {this, 0}; }
+    const_iterator cend() const noexcept { return {this, size_}; }
+
+    // Итератор по строкам; разыменование даёт кортеж ссылок на поля строки
+    template <bool IsConst>
+    class RowIterator {
+        using Owner = std::conditional_t<IsConst, const SoAVector, SoAVector>;
+
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using iterator_concept = std::random_access_iterator_tag;
+        using value_type = SoAVector::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<IsConst, const_reference, SoAVector::reference>;
+
+        RowIterator() = default;
+
+        RowIterator(Owner* owner, size_t index) noexcept
+            : owner_(owner)
+            , index_(index)
+        {
+        }
+
+        // Неконстантный итератор неявно преобразуется в константный
+        operator RowIterator<true>() const noexcept {
+            return {owner_, index_};
+        }
+
+        reference operator*() const noexcept { return (*owner_)[index_]; }
+        reference operator[](difference_type n) const noexcept { return (*owner_)[index_ + n]; }
+
+        RowIterator& operator++() noexcept { ++index_; return *this; }
+        RowIterator operator++(int) noexcept { RowIterator copy(*this); ++index_; return copy; }
+        RowIterator& operator--() noexcept { --index_; return *this; }
+        RowIterator operator--(int) noexcept { RowIterator copy(*this); --index_; return copy; }
+        RowIterator& operator+=(difference_type n) noexcept { index_ += n; return *this; }
+        RowIterator& operator-=(difference_type n) noexcept { index_ -= n; return *this; }
+
+        friend RowIterator operator+(RowIterator it, difference_type n) noexcept { return it += n; }
+        friend RowIterator operator+(difference_type n, RowIterator it) noexcept { return it += n; }
+        friend RowIterator operator-(RowIterator it, difference_type n) noexcept { return it -= n; }
+        friend difference_type operator-(const RowIterator& lhs, const RowIterator& rhs) noexcept {
+            return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+        }
+
+        friend bool operator==(const RowIterator& lhs, const RowIterator& rhs) noexcept {
+            return lhs.index_ == rhs.index_;
+        }
+        friend auto operator<=>(const RowIterator& lhs, const RowIterator& rhs) noexcept {
+            return lhs.index_ <=> rhs.index_;
+        }
+
+    private:
+        Owner* owner_ = nullptr;
+        size_t index_ = 0;
+    };
+
+private:
+    std::tuple<RawMemory<Fields>...> columns_;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+
+    template <typename Reference, size_t... Is>
+    Reference Row(size_t index, std::index_sequence<Is...>) noexcept {
+        return Reference(std::get<Is>(columns_)[index]...);
+    }
+
+    // Создаёт поля строки size_ в столбцах columns по одному, разрушая уже созданные при исключении
+    template <size_t I, size_t... Is, typename Arg, typename... Args>
+    static void ConstructRow(std::tuple<RawMemory<Fields>...>& columns, std::index_sequence<I, Is...>,
+                             size_t index, Arg&& arg, Args&&... args) {
+        FieldType<I>* slot = std::get<I>(columns).GetAddress() + index;
+        new (slot) FieldType<I>(std::forward<Arg>(arg));
+        if constexpr (sizeof...(Is) != 0) {
+            try {
+                ConstructRow(columns, std::index_sequence<Is...>{}, index, std::forward<Args>(args)...);
+            } catch (...) {
+                std::destroy_at(slot);
+                throw;
+            }
+        }
+    }
+
+    template <size_t... Is>
+    void DestroyRows(size_t first, size_t count, std::index_sequence<Is...>) noexcept {
+        (std::destroy_n(std::get<Is>(columns_).GetAddress() + first, count), ...);
+    }
+
+    template <size_t... Is>
+    void TransferColumns(std::tuple<RawMemory<Fields>...>& new_columns, std::index_sequence<Is...>) noexcept {
+        (TransferColumn(std::get<Is>(columns_), std::get<Is>(new_columns)), ...);
+    }
+
+    template <typename Field>
+    void TransferColumn(RawMemory<Field>& from, RawMemory<Field>& to) noexcept {
+        if constexpr (IsTriviallyRelocatable<Field>::value) {
+            if (size_ != 0) {
+                std::memcpy(static_cast<void*>(to.GetAddress()), static_cast<const void*>(from.GetAddress()),
+                            size_ * sizeof(Field));
+            }
+        }
+        else {
+            std::uninitialized_move_n(from.GetAddress(), size_, to.GetAddress());
+            std::destroy_n(from.GetAddress(), size_);
+        }
+    }
+};
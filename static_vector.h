@@ -0,0 +1,245 @@
+#pragma once
+#include "vector.h"
+
+#include <initializer_list>
+#include <stdexcept>
+
+// Вектор фиксированной ёмкости N с элементами прямо в объекте, без обращений к куче.
+// Добавление сверх ёмкости выбрасывает std::length_error. Интерфейс повторяет Vector.
+// Для тривиальных типов элементы хранятся в обычном массиве, поэтому вектор можно заполнить
+// при вычислениях на этапе компиляции и сохранить в constexpr-переменной как готовую таблицу
+template <typename T, size_t N>
+class StaticVector {
+    static_assert(N > 0, "Capacity must be positive");
+
+    static constexpr bool TRIVIAL_STORAGE =
+        std::is_trivially_default_constructible_v<T> && std::is_trivially_destructible_v<T>;
+
+    struct TrivialStorage {
+        T elements[N] = {};
+
+        constexpr T* Data() noexcept {
+            return elements;
+        }
+    };
+
+    struct RawStorage {
+        alignas(T) unsigned char bytes[N * sizeof(T)];
+
+        T* Data() noexcept {
+            return reinterpret_cast<T*>(bytes);
+        }
+    };
+
+    using Storage = std::conditional_t<TRIVIAL_STORAGE, TrivialStorage, RawStorage>;
+
+public:
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    constexpr StaticVector() noexcept = default;
+
+    constexpr explicit StaticVector(size_t size) {
+        CheckCapacity(size);
+        vector_detail::UninitializedValueConstructN(Data(), size);
+        size_ = size;
+    }
+
+    constexpr StaticVector(std::initializer_list<T> values) {
+        CheckCapacity(values.size());
+        vector_detail::UninitializedCopyN(values.begin(), values.size(), Data());
+        size_ = values.size();
+    }
+
+    constexpr StaticVector(const StaticVector& other) {
+        vector_detail::UninitializedCopyN(other.Data(), other.size_, Data());
+        size_ = other.size_;
+    }
+
+    // Элементы перемещаются по одному; other остаётся пустым
+    constexpr StaticVector(StaticVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        vector_detail::UninitializedMoveN(other.Data(), other.size_, Data());
+        size_ = other.size_;
+        other.Clear();
+    }
+
+    constexpr StaticVector& operator=(const StaticVector& rhs) {
+        if (this != &rhs) {
+            AssignElements(rhs.Data(), rhs.size_, [](const T& value) -> const T& {
+                return value;
+            });
+        }
+        return *this;
+    }
+
+    constexpr StaticVector& operator=(StaticVector&& rhs) noexcept(std::is_nothrow_move_assignable_v<T>
+                                                                   && std::is_nothrow_move_constructible_v<T>) {
+        if (this != &rhs) {
+            AssignElements(rhs.Data(), rhs.size_, [](T& value) -> T&& {
+                return std::move(value);
+            });
+            rhs.Clear();
+        }
+        return *this;
+    }
+
+    ~StaticVector() requires std::is_trivially_destructible_v<T> = default;
+
+    constexpr ~StaticVector() {
+        std::destroy_n(Data(), size_);
+    }
+
+    constexpr void Resize(size_t new_size) {
+        if (new_size < size_) {
+            std::destroy_n(Data() + new_size, size_ - new_size);
+            size_ = new_size;
+            return;
+        }
+        CheckCapacity(new_size);
+        vector_detail::UninitializedValueConstructN(Data() + size_, new_size - size_);
+        size_ = new_size;
+    }
+
+    constexpr void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    constexpr void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    constexpr void PopBack() noexcept {
+        if (size_ != 0) {
+            --size_;
+            std::destroy_at(Data() + size_);
+        }
+    }
+
+    template <typename... Args>
+    constexpr T& EmplaceBack(Args&&... args) {
+        CheckCapacity(size_ + 1);
+        T* slot = std::construct_at(end(), std::forward<Args>(args)...);
+        ++size_;
+        return *slot;
+    }
+
+    constexpr size_t Size() const noexcept {
+        return size_;
+    }
+
+    static constexpr size_t Capacity() noexcept {
+        return N;
+    }
+
+    constexpr const T& operator[](size_t index) const noexcept {
+        return const_cast<StaticVector&>(*this)[index];
+    }
+
+    constexpr T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return Data()[index];
+    }
+
+    constexpr void Clear() noexcept {
+        std::destroy_n(Data(), size_);
+        size_ = 0;
+    }
+
+    // Элементы обмениваются по одному, лишние элементы большего вектора перемещаются в меньший
+    constexpr void Swap(StaticVector& other) noexcept(std::is_nothrow_move_constructible_v<T>
+                                                      && std::is_nothrow_swappable_v<T>) {
+        StaticVector& larger = size_ >= other.size_ ? *this : other;
+        StaticVector& smaller = size_ >= other.size_ ? other : *this;
+        using std::swap;
+        for (size_t i = 0; i != smaller.size_; ++i) {
+            swap(larger.Data()[i], smaller.Data()[i]);
+        }
+        size_t n_extra = larger.size_ - smaller.size_;
+        vector_detail::UninitializedMoveN(larger.Data() + smaller.size_, n_extra, smaller.Data() + smaller.size_);
+        std::destroy_n(larger.Data() + smaller.size_, n_extra);
+        std::swap(size_, other.size_);
+    }
+
+    template <typename... Args>
+    constexpr iterator Emplace(const_iterator pos, Args&&... args) {
+        size_t i_pos = std::distance(cbegin(), pos);
+        CheckCapacity(size_ + 1);
+        if (i_pos == size_) {
+            std::construct_at(end(), std::forward<Args>(args)...);
+        }
+        else {
+            // Временный объект защищает от аргументов, ссылающихся на элементы самого вектора
+            T value(std::forward<Args>(args)...);
+            std::construct_at(end(), std::move(*(end() - 1)));
+            // Новый последний элемент учитывается сразу, чтобы не потерять его при исключении в сдвиге
+            ++size_;
+            std::move_backward(begin() + i_pos, end() - 2, end() - 1);
+            Data()[i_pos] = std::move(value);
+            return begin() + i_pos;
+        }
+        ++size_;
+        return begin() + i_pos;
+    }
+
+    constexpr iterator Erase(const_iterator pos) noexcept(std::is_nothrow_move_assignable_v<T>) {
+        size_t i_pos = std::distance(cbegin(), pos);
+        std::move(begin() + i_pos + 1, end(), begin() + i_pos);
+        PopBack();
+        return begin() + i_pos;
+    }
+
+    constexpr iterator Insert(const_iterator pos, const T& value) {
+        return Emplace(pos, value);
+    }
+    constexpr iterator Insert(const_iterator pos, T&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    constexpr iterator begin() noexcept { return Data(); }
+    constexpr iterator end() noexcept { return Data() + size_; }
+    constexpr const_iterator begin() const noexcept { return Data(); }
+    constexpr const_iterator end() const noexcept { return Data() + size_; }
+    constexpr const_iterator cbegin() const noexcept { return Data(); }
+    constexpr const_iterator cend() const noexcept { return Data() + size_; }
+
+    friend constexpr bool operator==(const StaticVector& lhs, const StaticVector& rhs)
+        requires std::equality_comparable<T>
+    {
+        return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+private:
+    Storage storage_;
+    size_t size_ = 0;
+
+    constexpr T* Data() noexcept {
+        return storage_.Data();
+    }
+
+    constexpr const T* Data() const noexcept {
+        return const_cast<StaticVector&>(*this).Data();
+    }
+
+    static constexpr void CheckCapacity(size_t size) {
+        if (size > N) {
+            throw std::length_error("StaticVector capacity exceeded");
+        }
+    }
+
+    // Присваивает элементам значения из [src, src + count).
+    // get преобразует исходный элемент в ссылку нужной категории (копирование или перемещение)
+    template <typename U, typename Getter>
+    constexpr void AssignElements(U* src, size_t count, Getter get) {
+        size_t n_to_assign = std::min(size_, count);
+        for (size_t i = 0; i != n_to_assign; ++i) {
+            Data()[i] = get(src[i]);
+        }
+        for (; size_ < count; ++size_) {
+            std::construct_at(Data() + size_, get(src[size_]));
+        }
+        if (count < size_) {
+            std::destroy_n(Data() + count, size_ - count);
+            size_ = count;
+        }
+    }
+};
@@ -0,0 +1,197 @@
+#pragma once
+#include "vector.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <istream>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <thread>
+
+// Настройки StreamingFill
+struct StreamingOptions {
+    // Наибольшее число элементов, которое производитель заполняет за один вызов
+    size_t chunk_size = size_t{1} << 14;
+    // Ожидаемый итоговый размер вектора, например размер файла, делённый на размер записи.
+    // Память под него резервируется заранее, и фоновый поток заполняет только её
+    size_t expected_size = 0;
+};
+
+// Заполняет вектор из источника порциями в фоновом потоке, пока другие потоки читают
+// уже заполненное начало: пока потребитель разбирает готовые порции, производитель пишет следующую.
+// Производитель — вызываемый объект size_t(std::span<T> chunk): он записывает элементы прямо
+// в новые элементы вектора, полученные через AppendUninitialized, и возвращает их число;
+// 0 означает конец источника. Промежуточных буферов и копирований нет. Каждый вызов получает
+// порцию ровно из chunk_size элементов; производитель может заполнить и меньше.
+//
+// Пока идёт заполнение, с вектором работает только StreamingFill: фоновый поток пишет
+// лишь в зарезервированную память, поэтому буфер не перемещается и префикс из WaitFor
+// и FilledPrefix остаётся действительным до вызова Finish. Если источник длиннее резерва,
+// фоновый поток останавливается, а остаток дочитывает Finish в вызывающем потоке
+// с обычным ростом вектора
+template <typename VectorType, typename Producer>
+class StreamingFill {
+    using T = typename VectorType::value_type;
+
+public:
+    StreamingFill(VectorType& target, Producer producer, const StreamingOptions& options = {})
+        : target_(target)
+        , producer_(std::move(producer))
+        , options_(options)
+    {
+        assert(options_.chunk_size != 0);
+        // Резерв кратен chunk_size, чтобы фоновый поток отдавал производителю только целые порции.
+        // Лишняя порция сверх ожидаемого размера остаётся свободной, даже если производитель
+        // заполняет порции не целиком, и позволяет обнаружить конец источника без перевыделения
+        const size_t size = target_.Size();
+        const size_t wanted = std::max(options_.expected_size, size) - size;
+        const size_t n_chunks = (wanted + options_.chunk_size - 1) / options_.chunk_size + 1;
+        target_.Reserve(size + n_chunks * options_.chunk_size);
+        data_ = target_.Data();
+        filled_ = target_.Size();
+        worker_ = std::thread([this] {
+            Run();
+        });
+    }
+
+    StreamingFill(const StreamingFill&) = delete;
+    StreamingFill& operator=(const StreamingFill&) = delete;
+
+    // Останавливает фоновый поток после текущей порции; ошибка производителя при этом теряется
+    ~StreamingFill() {
+        Cancel();
+        if (worker_.joinable()) {
+            worker_.join();
+        }
+    }
+
+    // Число элементов вектора, которые уже можно читать
+    size_t Filled() const noexcept {
+        return filled_.load(std::memory_order_acquire);
+    }
+
+    std::span<const T> FilledPrefix() const noexcept {
+        return {data_, Filled()};
+    }
+
+    // Ждёт, пока заполнятся хотя бы n элементов или фоновый поток остановится,
+    // и возвращает заполненное начало вектора
+    std::span<const T> WaitFor(size_t n) const {
+        std::unique_lock lock(mutex_);
+        published_.wait(lock, [this, n] {
+            return Filled() >= n || !streaming_;
+        });
+        return FilledPrefix();
+    }
+
+    // Истинно, когда фоновый поток остановился
+    bool Done() const {
+        std::lock_guard lock(mutex_);
+        return !streaming_;
+    }
+
+    // Просит фоновый поток остановиться после текущей порции; Finish после этого не дочитывает источник
+    void Cancel() noexcept {
+        cancelled_.store(true, std::memory_order_relaxed);
+    }
+
+    // Дожидается фонового потока и дочитывает источник, если он не поместился в резерв.
+    // Пробрасывает исключение производителя; вектор при этом содержит все порции до неудачной
+    VectorType& Finish() {
+        if (worker_.joinable()) {
+            worker_.join();
+        }
+        if (error_) {
+            end_of_source_ = true;
+            std::rethrow_exception(std::exchange(error_, nullptr));
+        }
+        while (!end_of_source_ && !cancelled_.load(std::memory_order_relaxed)) {
+            end_of_source_ = !FillChunk(options_.chunk_size);
+        }
+        return target_;
+    }
+
+private:
+    VectorType& target_;
+    Producer producer_;
+    StreamingOptions options_;
+    const T* data_ = nullptr;
+    std::atomic<size_t> filled_ = 0;
+    std::atomic<bool> cancelled_ = false;
+
+    mutable std::mutex mutex_;
+    mutable std::condition_variable published_;
+    // Защищён mutex_
+    bool streaming_ = true;
+
+    // Пишутся фоновым потоком и читаются после его завершения
+    bool end_of_source_ = false;
+    std::exception_ptr error_;
+
+    std::thread worker_;
+
+    void Run() noexcept {
+        bool more = true;
+        try {
+            while (more && !cancelled_.load(std::memory_order_relaxed)) {
+                if (target_.Capacity() - target_.Size() < options_.chunk_size) {
+                    break;
+                }
+                more = FillChunk(options_.chunk_size);
+                Publish(false);
+            }
+        } catch (...) {
+            error_ = std::current_exception();
+        }
+        end_of_source_ = !more;
+        Publish(true);
+    }
+
+    void Publish(bool last) {
+        {
+            std::lock_guard lock(mutex_);
+            filled_.store(target_.Size(), std::memory_order_release);
+            if (last) {
+                streaming_ = false;
+            }
+        }
+        published_.notify_all();
+    }
+
+    // Добавляет порцию до n элементов и отдаёт её производителю; false, если источник исчерпан.
+    // Если производитель выбросит исключение, порция удаляется
+    bool FillChunk(size_t n) {
+        const size_t old_size = target_.Size();
+        std::span<T> chunk = target_.AppendUninitialized(n);
+        size_t n_written = 0;
+        try {
+            n_written = producer_(chunk);
+        } catch (...) {
+            target_.Resize(old_size);
+            throw;
+        }
+        assert(n_written <= n);
+        target_.Resize(old_size + n_written);
+        return n_written != 0;
+    }
+};
+
+// Производитель для StreamingFill, читающий из потока байты элементов как они лежат в памяти.
+// Выбрасывает std::runtime_error, если поток обрывается посреди элемента или чтение не удалось
+template <typename T>
+auto StreamProducer(std::istream& in) {
+    static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable elements can be read as bytes");
+    return [&in](std::span<T> chunk) -> size_t {
+        in.read(reinterpret_cast<char*>(chunk.data()), static_cast<std::streamsize>(chunk.size_bytes()));
+        if (in.bad()) {
+            throw std::runtime_error("StreamProducer: read failed");
+        }
+        const size_t n_bytes = static_cast<size_t>(in.gcount());
+        if (n_bytes % sizeof(T) != 0) {
+            throw std::runtime_error("StreamProducer: truncated element");
+        }
+        return n_bytes / sizeof(T);
+    };
+}
@@ -1,84 +1,445 @@
 #pragma once
 #include <memory>
 #include <cassert>
+#include <cstddef>
 #include <algorithm>
+#include <concepts>
 #include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <limits>
 #include <new>
+#include <ranges>
+#include <span>
+#include <type_traits>
 #include <utility>
 
+#include "parallel.h"
+
+// Тип считается тривиально перемещаемым, если перенос объекта в новую память
+// с помощью memcpy и последующее "забывание" старой копии (без вызова деструктора)
+// эквивалентно перемещению с разрушением исходного объекта.
+// Для тривиально копируемых типов это верно всегда. Остальные типы можно
+// пометить явно, специализировав шаблон.
+template <typename T>
+struct IsTriviallyRelocatable : std::is_trivially_copyable<T> {};
+
+template <typename T, typename Deleter>
+struct IsTriviallyRelocatable<std::unique_ptr<T, Deleter>> : IsTriviallyRelocatable<Deleter> {};
+
+template <typename T>
+struct IsTriviallyRelocatable<std::shared_ptr<T>> : std::true_type {};
+
+template <typename T>
+struct IsTriviallyRelocatable<std::weak_ptr<T>> : std::true_type {};
+
+// std::string намеренно не помечен: в libstdc++ строка с коротким содержимым
+// хранит указатель на собственный внутренний буфер и не переживает memcpy.
+
+/*------------------------------------------*/
+/*------------------------------------------*/
+/*------------------------------------------*/
+
+inline constexpr size_t CACHE_LINE_SIZE = 64;
+
+// Аллокатор, выравнивающий начало буфера по границе Alignment байт (не меньше alignof(T)).
+// Размер выделяемого блока округляется вверх до кратного Alignment, поэтому буфер
+// не делит кэш-линию ни с какими другими данными.
+template <typename T, size_t Alignment = CACHE_LINE_SIZE>
+class AlignedAllocator {
+    static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+
+public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    static constexpr size_t ALIGNMENT = std::max(Alignment, alignof(T));
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() noexcept = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>& /*other*/) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(operator new(RoundUp(n * sizeof(T)), std::align_val_t(ALIGNMENT)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        operator delete(p, RoundUp(n * sizeof(T)), std::align_val_t(ALIGNMENT));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>& /*other*/) const noexcept {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>& /*other*/) const noexcept {
+        return false;
+    }
+
+private:
+    static size_t RoundUp(size_t bytes) noexcept {
+        return (bytes + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    }
+};
+
+// Аллокатор может предоставить метод reallocate(p, old_n, new_n), увеличивающий блок
+// с сохранением его содержимого: на месте, если это возможно, или с побайтовым переносом.
+// Например, поверх jemalloc его можно реализовать через xallocx с откатом на rallocx.
+// Vector пользуется им только для тривиально перемещаемых элементов.
+template <typename Allocator, typename = void>
+struct HasReallocate : std::false_type {};
+
+template <typename Allocator>
+struct HasReallocate<Allocator, std::void_t<decltype(std::declval<Allocator&>().reallocate(
+                                    std::declval<typename Allocator::value_type*>(), size_t{}, size_t{}))>>
+    : std::true_type {};
+
+// Аллокатор поверх malloc/realloc/free. realloc в glibc расширяет блок на месте,
+// когда за ним есть свободное место, а большие блоки переотображает через mremap
+// без копирования и без удвоения пикового потребления памяти.
+template <typename T>
+class MallocAllocator {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "malloc cannot satisfy the alignment of T");
+
+public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    MallocAllocator() noexcept = default;
+
+    template <typename U>
+    MallocAllocator(const MallocAllocator<U>& /*other*/) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        void* p = std::malloc(n * sizeof(T));
+        if (p == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, size_t /*n*/) noexcept {
+        std::free(p);
+    }
+
+    // При нехватке памяти выбрасывает std::bad_alloc, исходный блок при этом остаётся нетронутым
+    T* reallocate(T* p, size_t /*old_n*/, size_t new_n) {
+        if (new_n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        void* new_p = std::realloc(static_cast<void*>(p), new_n * sizeof(T));
+        if (new_p == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(new_p);
+    }
+
+    template <typename U>
+    bool operator==(const MallocAllocator<U>& /*other*/) const noexcept {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const MallocAllocator<U>& /*other*/) const noexcept {
+        return false;
+    }
+};
+
+/*------------------------------------------*/
+/*------------------------------------------*/
+/*------------------------------------------*/
+
+// Политика статистики получает уведомления о выделениях памяти и переносах элементов.
+// NoStats ничего не делает и полностью исчезает при компиляции; подсчитывающая политика
+// CountingStats объявлена в vector_stats.h.
+struct NoStats {
+    // Выделен или освобождён буфер на n элементов
+    template <typename T>
+    static constexpr void OnAllocate(size_t /*n*/) noexcept {
+    }
+    template <typename T>
+    static constexpr void OnDeallocate(size_t /*n*/) noexcept {
+    }
+
+    // Элементы вектора перенесены в буфер другой ёмкости
+    template <typename T>
+    static constexpr void OnReallocation(size_t /*old_capacity*/, size_t /*new_capacity*/) noexcept {
+    }
+
+    // При переносе n элементов перемещены, скопированы или побайтово перенесены
+    template <typename T>
+    static constexpr void OnMoved(size_t /*n*/) noexcept {
+    }
+    template <typename T>
+    static constexpr void OnCopied(size_t /*n*/) noexcept {
+    }
+    template <typename T>
+    static constexpr void OnRelocated(size_t /*n*/) noexcept {
+    }
+
+    // Вектор с size элементами освобождает буфер ёмкостью capacity
+    template <typename T>
+    static constexpr void OnRelease(size_t /*size*/, size_t /*capacity*/) noexcept {
+    }
+};
+
+/*------------------------------------------*/
+/*------------------------------------------*/
+/*------------------------------------------*/
+
+// Алгоритмы std::uninitialized_* в C++20 не constexpr. При вычислении на этапе компиляции
+// элементы создаются по одному через construct_at (исключения там невозможны, откат не нужен)
+namespace vector_detail {
+
+template <typename InputIt, typename T>
+constexpr void UninitializedCopyN(InputIt first, size_t n, T* dst) {
+    if (std::is_constant_evaluated()) {
+        for (size_t i = 0; i != n; ++i, ++first) {
+            std::construct_at(dst + i, *first);
+        }
+    }
+    else {
+        std::uninitialized_copy_n(first, n, dst);
+    }
+}
+
 template <typename T>
+constexpr void UninitializedMoveN(T* first, size_t n, T* dst) {
+    if (std::is_constant_evaluated()) {
+        for (size_t i = 0; i != n; ++i) {
+            std::construct_at(dst + i, std::move(first[i]));
+        }
+    }
+    else {
+        std::uninitialized_move_n(first, n, dst);
+    }
+}
+
+template <typename T>
+constexpr void UninitializedMove(T* first, T* last, T* dst) {
+    UninitializedMoveN(first, static_cast<size_t>(last - first), dst);
+}
+
+template <typename T>
+constexpr void UninitializedFillN(T* dst, size_t n, const T& value) {
+    if (std::is_constant_evaluated()) {
+        for (size_t i = 0; i != n; ++i) {
+            std::construct_at(dst + i, value);
+        }
+    }
+    else {
+        std::uninitialized_fill_n(dst, n, value);
+    }
+}
+
+template <typename T>
+constexpr void UninitializedValueConstructN(T* dst, size_t n) {
+    if (std::is_constant_evaluated()) {
+        for (size_t i = 0; i != n; ++i) {
+            std::construct_at(dst + i);
+        }
+    }
+    else {
+        std::uninitialized_value_construct_n(dst, n);
+    }
+}
+
+// На этапе компиляции память нельзя оставить неинициализированной, поэтому элементы
+// инициализируются значением
+template <typename T>
+constexpr void UninitializedDefaultConstructN(T* dst, size_t n) {
+    if (std::is_constant_evaluated()) {
+        UninitializedValueConstructN(dst, n);
+    }
+    else {
+        std::uninitialized_default_construct_n(dst, n);
+    }
+}
+
+}  // namespace vector_detail
+
+/*------------------------------------------*/
+/*------------------------------------------*/
+/*------------------------------------------*/
+
+template <typename T, typename Allocator = std::allocator<T>, typename StatsPolicy = NoStats>
 class RawMemory {
+    using AllocTraits = std::allocator_traits<Allocator>;
+
 public:
+    using allocator_type = Allocator;
+
     RawMemory() = default;
 
-    explicit RawMemory(size_t capacity)
-        : buffer_(Allocate(capacity))
+    constexpr explicit RawMemory(const Allocator& alloc) noexcept
+        : alloc_(alloc) {
+    }
+
+    constexpr explicit RawMemory(size_t capacity, const Allocator& alloc = Allocator())
+        : alloc_(alloc)
+        , buffer_(Allocate(capacity))
         , capacity_(capacity) {
     }
 
-    ~RawMemory() {
-        Deallocate(buffer_);
+    // Принимает во владение буфер на capacity элементов, выделенный аллокатором, равным alloc
+    constexpr RawMemory(T* buffer, size_t capacity, const Allocator& alloc) noexcept
+        : alloc_(alloc)
+        , buffer_(buffer)
+        , capacity_(buffer != nullptr ? capacity : 0) {
+        if (buffer_ != nullptr) {
+            StatsPolicy::template OnAllocate<T>(capacity_);
+        }
+    }
+
+    constexpr ~RawMemory() {
+        Deallocate(buffer_, capacity_);
     }
 
     RawMemory(const RawMemory&) = delete;
     RawMemory& operator=(const RawMemory& rhs) = delete;
 
-    RawMemory(RawMemory&& other) noexcept {
-        buffer_ = std::exchange(other.buffer_, nullptr);
-        capacity_ = std::exchange(other.capacity_, 0);
+    constexpr RawMemory(RawMemory&& other) noexcept
+        : alloc_(std::move(other.alloc_))
+        , buffer_(std::exchange(other.buffer_, nullptr))
+        , capacity_(std::exchange(other.capacity_, 0)) {
     }
-    RawMemory& operator=(RawMemory&& rhs) noexcept {
-        buffer_ = std::exchange(rhs.buffer_, nullptr);
-        capacity_ = std::exchange(rhs.capacity_, 0);
 
+    // Владение памятью передаётся только вместе с аллокатором, которым она выделена.
+    // Если аллокатор не распространяется при перемещении, он должен быть равен аллокатору rhs.
+    constexpr RawMemory& operator=(RawMemory&& rhs) noexcept {
+        if (this != &rhs) {
+            Deallocate(buffer_, capacity_);
+            if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+                alloc_ = std::move(rhs.alloc_);
+            }
+            else {
+                assert(alloc_ == rhs.alloc_);
+            }
+            buffer_ = std::exchange(rhs.buffer_, nullptr);
+            capacity_ = std::exchange(rhs.capacity_, 0);
+        }
         return *this;
     }
 
-    T* operator+(size_t offset) noexcept {
+    constexpr T* operator+(size_t offset) noexcept {
         // Разрешается получать адрес ячейки памяти, следующей за последним элементом массива
         assert(offset <= capacity_);
         return buffer_ + offset;
     }
 
-    const T* operator+(size_t offset) const noexcept {
+    constexpr const T* operator+(size_t offset) const noexcept {
         return const_cast<RawMemory&>(*this) + offset;
     }
 
-    const T& operator[](size_t index) const noexcept {
+    constexpr const T& operator[](size_t index) const noexcept {
         return const_cast<RawMemory&>(*this)[index];
     }
 
-    T& operator[](size_t index) noexcept {
+    constexpr T& operator[](size_t index) noexcept {
         assert(index < capacity_);
         return buffer_[index];
     }
 
-    void Swap(RawMemory& other) noexcept {
+    // Аллокаторы обмениваются, только если этого требует propagate_on_container_swap.
+    // В противном случае обменивать можно лишь память, выделенную равными аллокаторами.
+    constexpr void Swap(RawMemory& other) noexcept {
+        if constexpr (AllocTraits::propagate_on_container_swap::value) {
+            using std::swap;
+            swap(alloc_, other.alloc_);
+        }
+        else {
+            assert(alloc_ == other.alloc_);
+        }
         std::swap(buffer_, other.buffer_);
         std::swap(capacity_, other.capacity_);
     }
 
-    const T* GetAddress() const noexcept {
+    constexpr const T* GetAddress() const noexcept {
         return buffer_;
     }
 
-    T* GetAddress() noexcept {
+    constexpr T* GetAddress() noexcept {
         return buffer_;
     }
 
-    size_t Capacity() const {
+    constexpr size_t Capacity() const {
         return capacity_;
     }
 
+    constexpr const Allocator& GetAllocator() const noexcept {
+        return alloc_;
+    }
+
+    // Отказывается от владения буфером и возвращает его. Освободить буфер должен вызывающий код
+    // аллокатором, равным GetAllocator(), с прежней ёмкостью
+    constexpr T* Release() noexcept {
+        if (buffer_ != nullptr) {
+            StatsPolicy::template OnDeallocate<T>(capacity_);
+        }
+        capacity_ = 0;
+        return std::exchange(buffer_, nullptr);
+    }
+
+    // Освобождает память и заменяет аллокатор независимо от propagate_on_container_move_assignment.
+    // Нужен копирующему присваиванию, когда propagate_on_container_copy_assignment требует
+    // перенять аллокатор источника
+    constexpr void ResetAllocator(const Allocator& alloc) noexcept {
+        Deallocate(buffer_, capacity_);
+        buffer_ = nullptr;
+        capacity_ = 0;
+        alloc_ = alloc;
+    }
+
+    // Меняет ёмкость, сохраняя байты буфера, которые в неё помещаются. Адрес буфера может измениться.
+    // Доступно только для аллокаторов с методом reallocate и тривиально перемещаемых T
+    void Reallocate(size_t new_capacity) {
+        static_assert(HasReallocate<Allocator>::value);
+        static_assert(IsTriviallyRelocatable<T>::value);
+        assert(new_capacity != 0);
+        if (buffer_ == nullptr) {
+            buffer_ = Allocate(new_capacity);
+        }
+        else {
+            buffer_ = alloc_.reallocate(buffer_, capacity_, new_capacity);
+            StatsPolicy::template OnDeallocate<T>(capacity_);
+            StatsPolicy::template OnAllocate<T>(new_capacity);
+        }
+        capacity_ = new_capacity;
+    }
+
 private:
-    static T* Allocate(size_t n) {
-        return n != 0 ? static_cast<T*>(operator new(n * sizeof(T))) : nullptr;
+    constexpr T* Allocate(size_t n) {
+        if (n == 0) {
+            return nullptr;
+        }
+        T* buf = AllocTraits::allocate(alloc_, n);
+        StatsPolicy::template OnAllocate<T>(n);
+        return buf;
     }
 
-    static void Deallocate(T* buf) noexcept {
-        operator delete(buf);
+    constexpr void Deallocate(T* buf, size_t n) noexcept {
+        if (buf != nullptr) {
+            AllocTraits::deallocate(alloc_, buf, n);
+            StatsPolicy::template OnDeallocate<T>(n);
+        }
     }
 
+    [[no_unique_address]] Allocator alloc_ = Allocator();
     T* buffer_ = nullptr;
     size_t capacity_ = 0;
 };
@@ -87,85 +448,271 @@ private:
 /*------------------------------------------*/
 /*------------------------------------------*/
 
+// Политики роста определяют ёмкость, которую получает заполненный вектор из size элементов
+// размером element_size байт при добавлении очередного элемента (NextCapacity, результат больше size),
+// и ёмкость, до которой вектор ужимается в ShrinkToFit (FitCapacity, результат не меньше size).
+// Первое выделение памяти сразу занимает целую кэш-линию, чтобы маленькие векторы
+// не перевыделялись по цепочке 1 -> 2 -> 4 -> 8.
+constexpr size_t MinGrowthCapacity(size_t element_size) noexcept {
+    return std::max<size_t>(1, CACHE_LINE_SIZE / element_size);
+}
+
+struct DoublingGrowth {
+    static constexpr size_t NextCapacity(size_t size, size_t element_size) noexcept {
+        return size == 0 ? MinGrowthCapacity(element_size) : size * 2;
+    }
+
+    static constexpr size_t FitCapacity(size_t size, size_t /*element_size*/) noexcept {
+        return size;
+    }
+};
+
+// Рост в 1.5 раза позволяет переиспользовать ранее освобождённые блоки и теряет меньше памяти
+struct GoldenGrowth {
+    static constexpr size_t NextCapacity(size_t size, size_t element_size) noexcept {
+        return std::max(size + size / 2 + 1, MinGrowthCapacity(element_size));
+    }
+
+    static constexpr size_t FitCapacity(size_t size, size_t /*element_size*/) noexcept {
+        return size;
+    }
+};
+
+// Удваивает ёмкость и округляет размер блока вверх до класса размеров jemalloc/tcmalloc,
+// чтобы байты, которые аллокатор всё равно выделил бы, достались элементам
+struct SizeClassGrowth {
+    static constexpr size_t NextCapacity(size_t size, size_t element_size) noexcept {
+        size_t capacity = DoublingGrowth::NextCapacity(size, element_size);
+        return std::max(capacity, RoundUpToSizeClass(capacity * element_size) / element_size);
+    }
+
+    static constexpr size_t FitCapacity(size_t size, size_t element_size) noexcept {
+        return size == 0 ? 0 : std::max(size, RoundUpToSizeClass(size * element_size) / element_size);
+    }
+
+    // Классы размеров: кратные 16 до 128 байт, далее по четыре класса на каждую степень двойки
+    static constexpr size_t RoundUpToSizeClass(size_t bytes) noexcept {
+        if (bytes <= 8) {
+            return 8;
+        }
+        if (bytes <= 128) {
+            return (bytes + 15) & ~size_t{15};
+        }
+        size_t group = 128;
+        while (group * 2 < bytes) {
+            group *= 2;
+        }
+        size_t step = group / 4;
+        return (bytes + step - 1) & ~(step - 1);
+    }
+};
+
+/*------------------------------------------*/
+/*------------------------------------------*/
+/*------------------------------------------*/
+
+// Буфер, отданный вектором через Release(): первые size из capacity элементов живы
 template <typename T>
+struct ReleasedBuffer {
+    T* data = nullptr;
+    size_t size = 0;
+    size_t capacity = 0;
+};
+
+template <typename T, typename Allocator = std::allocator<T>, typename GrowthPolicy = DoublingGrowth,
+          typename StatsPolicy = NoStats>
 class Vector {
+    using AllocTraits = std::allocator_traits<Allocator>;
+    using Storage = RawMemory<T, Allocator, StatsPolicy>;
+
 public:
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
     using iterator = T*;
     using const_iterator = const T*;
+    using allocator_type = Allocator;
 
     Vector() = default;
 
-    explicit Vector(size_t size)
-        : data_(size)
+    constexpr explicit Vector(const Allocator& alloc) noexcept
+        : data_(alloc)
+    {
+    }
+
+    constexpr explicit Vector(size_t size, const Allocator& alloc = Allocator())
+        : data_(size, alloc)
         , size_(size)
     {
-        std::uninitialized_value_construct_n(data_.GetAddress(), size);
+        vector_detail::UninitializedValueConstructN(data_.GetAddress(), size);
+    }
+
+    // Для итераторов прямого доступа выделяет память ровно под размер диапазона один раз
+    template <std::input_iterator InputIt>
+    constexpr Vector(InputIt first, InputIt last, const Allocator& alloc = Allocator())
+        : data_(alloc)
+    {
+        if constexpr (std::forward_iterator<InputIt>) {
+            Reserve(std::distance(first, last));
+        }
+        Append(first, last);
+    }
+
+    constexpr Vector(const Vector& other)
+        : Vector(other, AllocTraits::select_on_container_copy_construction(other.GetAllocator()))
+    {
     }
 
-    Vector(const Vector& other)
-        : data_(other.size_)
+    constexpr Vector(const Vector& other, const Allocator& alloc)
+        : data_(other.size_, alloc)
         , size_(other.size_)
     {
-        std::uninitialized_copy_n(other.data_.GetAddress(), size_, data_.GetAddress());
+        vector_detail::UninitializedCopyN(other.data_.GetAddress(), size_, data_.GetAddress());
     }
 
-    Vector(Vector&& other) noexcept {
-        Swap(other);
+    constexpr Vector(Vector&& other) noexcept
+        : data_(std::move(other.data_))
+        , size_(std::exchange(other.size_, 0))
+    {
     }
 
-    Vector& operator=(const Vector& rhs) {
+    // Если аллокаторы не равны, память other не может быть присвоена,
+    // поэтому элементы перемещаются по одному
+    constexpr Vector(Vector&& other, const Allocator& alloc)
+        : data_(alloc)
+    {
+        if (alloc == other.GetAllocator()) {
+            data_.Swap(other.data_);
+            size_ = std::exchange(other.size_, 0);
+        }
+        else {
+            Storage new_data(other.size_, alloc);
+            vector_detail::UninitializedMoveN(other.data_.GetAddress(), other.size_, new_data.GetAddress());
+            data_.Swap(new_data);
+            size_ = other.size_;
+        }
+    }
+
+    constexpr Vector& operator=(const Vector& rhs) {
         if (this != &rhs) {
+            if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+                if (GetAllocator() != rhs.GetAllocator()) {
+                    // Элементы должны быть освобождены старым аллокатором, а скопированы в память нового
+                    Vector rhs_copy(rhs, rhs.GetAllocator());
+                    ReleaseMemory();
+                    data_.ResetAllocator(rhs.GetAllocator());
+                    Swap(rhs_copy);
+                    return *this;
+                }
+            }
             if (rhs.size_ > data_.Capacity()) {
-                Vector rhs_copy(rhs);
+                Vector rhs_copy(rhs, GetAllocator());
                 Swap(rhs_copy);
             }
             else {
-                size_t n_to_copy = std::min(size_, rhs.size_);
-                std::copy_n(rhs.data_.GetAddress(), n_to_copy, data_.GetAddress());
+                AssignElements(rhs.data_.GetAddress(), rhs.size_, [](const T& value) -> const T& {
+                    return value;
+                });
+            }
+        }
+        return *this;
+    }
 
-                if (rhs.size_ > size_) {
-                    std::uninitialized_copy_n(rhs.data_.GetAddress() + n_to_copy, rhs.size_ - size_, data_.GetAddress() + n_to_copy);
+    constexpr Vector& operator=(Vector&& rhs) noexcept(AllocTraits::propagate_on_container_move_assignment::value
+                                                       || AllocTraits::is_always_equal::value) {
+        if constexpr (!AllocTraits::propagate_on_container_move_assignment::value
+                      && !AllocTraits::is_always_equal::value) {
+            if (GetAllocator() != rhs.GetAllocator()) {
+                if (rhs.size_ > data_.Capacity()) {
+                    Vector rhs_copy(std::move(rhs), GetAllocator());
+                    Swap(rhs_copy);
                 }
                 else {
-                    std::destroy_n(data_.GetAddress() + n_to_copy, size_ - rhs.size_);
+                    AssignElements(rhs.data_.GetAddress(), rhs.size_, [](T& value) -> T&& {
+                        return std::move(value);
+                    });
                 }
-                size_ = rhs.size_;
+                return *this;
             }
         }
+        if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+            Clear();
+            data_ = std::move(rhs.data_);
+            size_ = std::exchange(rhs.size_, 0);
+        }
+        else {
+            Swap(rhs);
+        }
         return *this;
     }
 
-    Vector& operator=(Vector&& rhs) noexcept {
-        Swap(rhs);
-        return *this;
-    }
-
-    ~Vector() {
+    constexpr ~Vector() {
+        if (data_.Capacity() != 0) {
+            StatsPolicy::template OnRelease<T>(size_, data_.Capacity());
+        }
         if (size_ != 0) {
             std::destroy_n(data_.GetAddress(), size_);
         }
     }
 
-    void Resize(size_t new_size) {
+    constexpr void Resize(size_t new_size) {
+        if (new_size < size_) {
+            std::destroy_n(data_.GetAddress() + new_size, size_ - new_size);
+            size_ = new_size;
+            return;
+        }
+        Reserve(new_size);
+        vector_detail::UninitializedValueConstructN(data_.GetAddress() + size_, new_size - size_);
+        size_ = new_size;
+    }
+
+    // В отличие от Resize, новые элементы инициализируются по умолчанию, а не значением:
+    // для тривиальных типов память не обнуляется
+    constexpr void ResizeDefaultInit(size_t new_size) {
         if (new_size < size_) {
             std::destroy_n(data_.GetAddress() + new_size, size_ - new_size);
             size_ = new_size;
             return;
         }
         Reserve(new_size);
-        std::uninitialized_value_construct_n(data_.GetAddress() + size_, new_size - size_);
+        vector_detail::UninitializedDefaultConstructN(data_.GetAddress() + size_, new_size - size_);
+        size_ = new_size;
+    }
+
+    // Меняет размер, не трогая память новых элементов. Содержимое должен записать вызывающий код
+    constexpr void ResizeUninitialized(size_t new_size) {
+        static_assert(std::is_trivially_default_constructible_v<T> && std::is_trivially_destructible_v<T>,
+                      "Uninitialized elements are only allowed for trivial types");
+        Reserve(new_size);
         size_ = new_size;
     }
 
-    void PushBack(const T& value) {
+    // Добавляет в конец n элементов, инициализированных по умолчанию, и возвращает их для заполнения,
+    // например через read() или декодер. Ёмкость растёт по GrowthPolicy, поэтому серия вызовов
+    // выполняется за амортизированное линейное время
+    constexpr std::span<T> AppendUninitialized(size_t n) {
+        if (size_ + n > data_.Capacity()) {
+            Reserve(std::max(size_ + n, GrowthPolicy::NextCapacity(size_, sizeof(T))));
+        }
+        T* first = data_.GetAddress() + size_;
+        vector_detail::UninitializedDefaultConstructN(first, n);
+        size_ += n;
+        return {first, n};
+    }
+
+    constexpr void PushBack(const T& value) {
         EmplaceBack(value);
     }
 
-    void PushBack(T&& value) {
+    constexpr void PushBack(T&& value) {
         EmplaceBack(std::move(value));
     }
 
-    void PopBack() noexcept {
+    constexpr void PopBack() noexcept {
         if (size_ != 0) {
             --size_;
             Destroy(data_.GetAddress() + size_);
@@ -173,50 +720,191 @@ public:
     }
 
     template <typename... Args>
-    T& EmplaceBack(Args&&... args) {
-        return *Emplace(cend(), std::forward<Args>(args)...);
+    constexpr T& EmplaceBack(Args&&... args) {
+        if (size_ < data_.Capacity()) {
+            T* slot = std::construct_at(end(), std::forward<Args>(args)...);
+            ++size_;
+            return *slot;
+        }
+        return *EmplaceNewAlloc(cend(), std::forward<Args>(args)...);
     }
 
-    size_t Size() const noexcept {
+    constexpr size_t Size() const noexcept {
         return size_;
     }
 
-    size_t Capacity() const noexcept {
+    constexpr size_t Capacity() const noexcept {
         return data_.Capacity();
     }
 
-    const T& operator[](size_t index) const noexcept {
+    constexpr const T& operator[](size_t index) const noexcept {
         return const_cast<Vector&>(*this)[index];
     }
 
-    T& operator[](size_t index) noexcept {
+    constexpr T& operator[](size_t index) noexcept {
         assert(index < size_);
         return data_[index];
     }
 
-    void Swap(Vector& other) noexcept {
-        std::swap(data_, other.data_);
+    constexpr void Swap(Vector& other) noexcept {
+        data_.Swap(other.data_);
         std::swap(size_, other.size_);
     }
 
-    void Reserve(size_t new_capacity) {
+    constexpr allocator_type GetAllocator() const noexcept {
+        return data_.GetAllocator();
+    }
+
+    // Целые, перечисления и указатели сравниваются одним memcmp. Остальные типы — через operator==,
+    // даже если однозначно представлены байтами: их сравнение может учитывать не все поля
+    friend constexpr bool operator==(const Vector& lhs, const Vector& rhs)
+        requires std::equality_comparable<T>
+    {
+        if (lhs.size_ != rhs.size_) {
+            return false;
+        }
+        if constexpr (std::is_integral_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>) {
+            if (!std::is_constant_evaluated()) {
+                return lhs.size_ == 0
+                       || std::memcmp(lhs.data_.GetAddress(), rhs.data_.GetAddress(), lhs.size_ * sizeof(T)) == 0;
+            }
+        }
+        return std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    constexpr void Reserve(size_t new_capacity) {
         if (new_capacity <= data_.Capacity()) {
             return;
         }
-        RawMemory<T> new_data(new_capacity);
+        SetCapacity(new_capacity);
+    }
 
-        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-            std::uninitialized_move_n(data_.GetAddress(), size_, new_data.GetAddress());
+    // Уменьшает ёмкость до размера, округлённого политикой роста (например, до класса размеров аллокатора)
+    constexpr void ShrinkToFit() {
+        size_t new_capacity = GrowthPolicy::FitCapacity(size_, sizeof(T));
+        if (new_capacity >= data_.Capacity()) {
+            return;
         }
-        else {
-            std::uninitialized_copy_n(data_.GetAddress(), size_, new_data.GetAddress());
+        if (new_capacity == 0) {
+            ReleaseMemory();
+            return;
         }
+        SetCapacity(new_capacity);
+    }
+
+    // Удаляет все элементы, сохраняя ёмкость
+    constexpr void Clear() noexcept {
         std::destroy_n(data_.GetAddress(), size_);
-        data_.Swap(new_data);
+        size_ = 0;
+    }
+
+    // Удаляет все элементы и возвращает память аллокатору
+    constexpr void ReleaseMemory() noexcept {
+        if (data_.Capacity() != 0) {
+            StatsPolicy::template OnRelease<T>(size_, data_.Capacity());
+        }
+        Clear();
+        Storage empty(data_.GetAllocator());
+        data_.Swap(empty);
+    }
+
+    // Принимает во владение буфер data на capacity элементов, в начале которого уже созданы
+    // size элементов. Буфер должен быть выделен аллокатором, равным alloc
+    static constexpr Vector Adopt(T* data, size_t size, size_t capacity, const Allocator& alloc = Allocator()) noexcept {
+        assert(size <= capacity && (data != nullptr || capacity == 0));
+        Vector result(alloc);
+        Storage adopted(data, capacity, alloc);
+        result.data_.Swap(adopted);
+        result.size_ = size;
+        return result;
+    }
+
+    // Передаёт буфер вызывающему коду вместе с живыми элементами; вектор остаётся пустым.
+    // Элементы нужно разрушить, а буфер освободить аллокатором, равным GetAllocator()
+    constexpr ReleasedBuffer<T> Release() noexcept {
+        if (data_.Capacity() != 0) {
+            StatsPolicy::template OnRelease<T>(size_, data_.Capacity());
+        }
+        ReleasedBuffer<T> released{nullptr, std::exchange(size_, 0), data_.Capacity()};
+        released.data = data_.Release();
+        return released;
+    }
+
+    constexpr T* Data() noexcept {
+        return data_.GetAddress();
+    }
+
+    constexpr const T* Data() const noexcept {
+        return data_.GetAddress();
+    }
+
+    constexpr std::span<T> Span() noexcept {
+        return {data_.GetAddress(), size_};
+    }
+
+    constexpr std::span<const T> Span() const noexcept {
+        return {data_.GetAddress(), size_};
+    }
+
+    // Параллельные версии массовых операций. Диапазон делится на части по options,
+    // каждая часть создаётся или разрушается своим потоком. Если часть выбрасывает исключение,
+    // уже созданные части разрушаются. Свежевыделенные страницы памяти впервые записываются
+    // потоком, создающим элементы, поэтому при политике first-touch они размещаются
+    // на узле NUMA этого потока
+
+    Vector(size_t size, const ParallelOptions& options, const Allocator& alloc = Allocator())
+        : data_(size, alloc)
+    {
+        ValueConstructParallel(data_.GetAddress(), size, options);
+        size_ = size;
+    }
+
+    Vector(const Vector& other, const ParallelOptions& options)
+        : data_(other.size_, AllocTraits::select_on_container_copy_construction(other.GetAllocator()))
+    {
+        CopyConstructParallel(other, options);
+    }
+
+    void ParallelResize(size_t new_size, const ParallelOptions& options = {}) {
+        if (new_size < size_) {
+            DestroyParallel(new_size, size_ - new_size, options);
+            size_ = new_size;
+            return;
+        }
+        Reserve(new_size);
+        ValueConstructParallel(data_.GetAddress() + size_, new_size - size_, options);
+        size_ = new_size;
+    }
+
+    // Базовая гарантия: при исключении вектор остаётся пустым. Буфер переиспользуется,
+    // если его ёмкости хватает и аллокатор не меняется
+    void ParallelAssign(const Vector& rhs, const ParallelOptions& options = {}) {
+        if (this == &rhs) {
+            return;
+        }
+        ParallelClear(options);
+        bool replace_allocator = false;
+        if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+            replace_allocator = GetAllocator() != rhs.GetAllocator();
+        }
+        if (replace_allocator || rhs.size_ > data_.Capacity()) {
+            ReleaseMemory();
+            if (replace_allocator) {
+                data_.ResetAllocator(rhs.GetAllocator());
+            }
+            Storage new_data(rhs.size_, GetAllocator());
+            data_.Swap(new_data);
+        }
+        CopyConstructParallel(rhs, options);
+    }
+
+    void ParallelClear(const ParallelOptions& options = {}) noexcept {
+        DestroyParallel(0, size_, options);
+        size_ = 0;
     }
 
     template <typename... Args>
-    iterator Emplace(const_iterator pos, Args&&... args) {
+    constexpr iterator Emplace(const_iterator pos, Args&&... args) {
         if (data_.Capacity() > size_) {
             return EmplaceNoAlloc(pos, std::forward<Args>(args)...);
         }
@@ -224,7 +912,7 @@ public:
     }
 
 
-    iterator Erase(const_iterator pos) noexcept(std::is_nothrow_move_assignable_v<T>) {
+    constexpr iterator Erase(const_iterator pos) noexcept(std::is_nothrow_move_assignable_v<T>) {
         size_t i_pos = std::distance(cbegin(), pos);
 
         std::move(begin() + i_pos + 1, end(), begin() + i_pos);
@@ -234,80 +922,463 @@ public:
         return begin() + i_pos;
     }
 
-    iterator Insert(const_iterator pos, const T& value) {
+    // Удаляет элементы [first, last), сдвигая хвост один раз
+    constexpr iterator Erase(const_iterator first, const_iterator last) noexcept(std::is_nothrow_move_assignable_v<T>) {
+        size_t i_first = std::distance(cbegin(), first);
+        size_t n = std::distance(first, last);
+        if (n != 0) {
+            std::move(begin() + i_first + n, end(), begin() + i_first);
+            std::destroy_n(end() - n, n);
+            size_ -= n;
+        }
+        return begin() + i_first;
+    }
+
+    // Удаляет элемент за O(1), перемещая на его место последний. Порядок элементов не сохраняется
+    constexpr iterator SwapErase(const_iterator pos) noexcept(std::is_nothrow_move_assignable_v<T>) {
+        size_t i_pos = std::distance(cbegin(), pos);
+        if (i_pos + 1 != size_) {
+            data_[i_pos] = std::move(data_[size_ - 1]);
+        }
+        PopBack();
+        return begin() + i_pos;
+    }
+
+    // Удаляет все элементы, удовлетворяющие pred, за один проход уплотнения
+    // и возвращает количество удалённых элементов
+    template <typename Predicate>
+    constexpr size_t EraseIf(Predicate pred) {
+        iterator new_end = std::remove_if(begin(), end(), pred);
+        size_t n_removed = std::distance(new_end, end());
+        std::destroy_n(new_end, n_removed);
+        size_ -= n_removed;
+        return n_removed;
+    }
+
+    constexpr iterator Insert(const_iterator pos, const T& value) {
         return Emplace(pos, value);
     }
-    iterator Insert(const_iterator pos, T&& value) {
+    constexpr iterator Insert(const_iterator pos, T&& value) {
         return Emplace(pos, std::move(value));
     }
 
-    iterator begin() noexcept { return data_.GetAddress(); }
-    iterator end() noexcept { return data_.GetAddress() + size_; }
-    const_iterator begin() const noexcept { return data_.GetAddress(); }
-    const_iterator end() const noexcept { return data_.GetAddress() + size_; }
-    const_iterator cbegin() const noexcept { return data_.GetAddress(); }
-    const_iterator cend() const noexcept { return data_.GetAddress() + size_; }
+    // Вставляет n копий value, выполняя не более одного перевыделения памяти и один сдвиг хвоста.
+    // value может ссылаться на элемент самого вектора
+    constexpr iterator Insert(const_iterator pos, size_t n, const T& value) {
+        size_t i_pos = std::distance(cbegin(), pos);
+        if (n == 0) {
+            return begin() + i_pos;
+        }
+        if (size_ + n > data_.Capacity()) {
+            return InsertNewAlloc(i_pos, n, [&value, n](T* dst) {
+                vector_detail::UninitializedFillN(dst, n, value);
+            });
+        }
+        const T value_copy(value);
+        InsertNoAlloc(
+            i_pos, n,
+            [&value_copy](T* dst, size_t /*offset*/, size_t count) {
+                vector_detail::UninitializedFillN(dst, count, value_copy);
+            },
+            [&value_copy](T* dst, size_t /*offset*/, size_t count) {
+                std::fill_n(dst, count, value_copy);
+            });
+        return begin() + i_pos;
+    }
+
+    // Вставляет элементы диапазона [first, last), который не должен ссылаться на элементы самого вектора.
+    // Для итераторов прямого доступа размер вычисляется заранее: память перевыделяется не более одного раза,
+    // хвост сдвигается один раз, а тривиально копируемые элементы из непрерывной памяти копируются memcpy
+    template <std::input_iterator InputIt>
+    constexpr iterator Insert(const_iterator pos, InputIt first, InputIt last) {
+        size_t i_pos = std::distance(cbegin(), pos);
+        if constexpr (std::forward_iterator<InputIt>) {
+            size_t n = std::distance(first, last);
+            if (n == 0) {
+                return begin() + i_pos;
+            }
+            if (size_ + n > data_.Capacity()) {
+                return InsertNewAlloc(i_pos, n, [first, n](T* dst) {
+                    CopyConstructN(first, n, dst);
+                });
+            }
+            InsertNoAlloc(
+                i_pos, n,
+                [first](T* dst, size_t offset, size_t count) {
+                    CopyConstructN(std::next(first, offset), count, dst);
+                },
+                [first](T* dst, size_t offset, size_t count) {
+                    std::copy_n(std::next(first, offset), count, dst);
+                });
+        }
+        else {
+            // Размер однопроходного диапазона заранее неизвестен: элементы добавляются в конец
+            // и затем одним поворотом переставляются на место. Если создание элемента или итератор
+            // выбросят исключение, добавленные элементы удаляются
+            size_t old_size = size_;
+            try {
+                for (; first != last; ++first) {
+                    EmplaceBack(*first);
+                }
+            } catch (...) {
+                std::destroy_n(data_.GetAddress() + old_size, size_ - old_size);
+                size_ = old_size;
+                throw;
+            }
+            std::rotate(begin() + i_pos, begin() + old_size, end());
+        }
+        return begin() + i_pos;
+    }
+
+    template <std::input_iterator InputIt>
+    constexpr void Append(InputIt first, InputIt last) {
+        Insert(cend(), first, last);
+    }
+
+    // Добавляет элементы диапазона, в том числе представления std::views с отдельным ограничителем.
+    // Для sized_range память выделяется не более одного раза до обхода, тривиально копируемые элементы
+    // непрерывного диапазона копируются memcpy. Если создание элемента выбросит исключение,
+    // добавленные элементы удаляются. Диапазон не должен ссылаться на элементы самого вектора
+    template <std::ranges::input_range Range>
+        requires std::constructible_from<T, std::ranges::range_reference_t<Range>>
+    constexpr void AppendRange(Range&& range) {
+        if constexpr (std::ranges::sized_range<Range>) {
+            const size_t n = static_cast<size_t>(std::ranges::size(range));
+            if (size_ + n > data_.Capacity()) {
+                Reserve(std::max(size_ + n, GrowthPolicy::NextCapacity(size_, sizeof(T))));
+            }
+            if constexpr (std::ranges::contiguous_range<Range>) {
+                CopyConstructN(std::ranges::begin(range), n, end());
+                size_ += n;
+                return;
+            }
+        }
+        const size_t old_size = size_;
+        try {
+            for (auto&& value : range) {
+                EmplaceBack(std::forward<decltype(value)>(value));
+            }
+        } catch (...) {
+            std::destroy_n(begin() + old_size, size_ - old_size);
+            size_ = old_size;
+            throw;
+        }
+    }
+
+    constexpr iterator begin() noexcept { return data_.GetAddress(); }
+    constexpr iterator end() noexcept { return data_.GetAddress() + size_; }
+    constexpr const_iterator begin() const noexcept { return data_.GetAddress(); }
+    constexpr const_iterator end() const noexcept { return data_.GetAddress() + size_; }
+    constexpr const_iterator cbegin() const noexcept { return data_.GetAddress(); }
+    constexpr const_iterator cend() const noexcept { return data_.GetAddress() + size_; }
 
 private:
-    RawMemory<T> data_;
+    // Рост через reallocate аллокатора: буфер расширяется на месте или переносится побайтово
+    static constexpr bool CAN_REALLOCATE = HasReallocate<Allocator>::value && IsTriviallyRelocatable<T>::value
+                                           && std::is_nothrow_move_constructible_v<T>;
+
+    Storage data_;
     size_t size_ = 0;
 
+    static void ValueConstructParallel(T* first, size_t n, const ParallelOptions& options) {
+        ParallelConstruct(
+            n, options,
+            [first](size_t begin, size_t end) {
+                std::uninitialized_value_construct(first + begin, first + end);
+            },
+            [first](size_t begin, size_t end) {
+                std::destroy(first + begin, first + end);
+            });
+    }
+
+    // Копирует элементы other в пустой вектор, ёмкости которого достаточно
+    void CopyConstructParallel(const Vector& other, const ParallelOptions& options) {
+        assert(size_ == 0 && data_.Capacity() >= other.size_);
+        const T* src = other.data_.GetAddress();
+        T* dst = data_.GetAddress();
+        ParallelConstruct(
+            other.size_, options,
+            [src, dst](size_t begin, size_t end) {
+                std::uninitialized_copy(src + begin, src + end, dst + begin);
+            },
+            [dst](size_t begin, size_t end) {
+                std::destroy(dst + begin, dst + end);
+            });
+        size_ = other.size_;
+    }
+
+    void DestroyParallel(size_t first, size_t n, const ParallelOptions& options) noexcept {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            T* elements = data_.GetAddress() + first;
+            ParallelFor(n, options, [elements](size_t begin, size_t end) noexcept {
+                std::destroy(elements + begin, elements + end);
+            });
+        }
+    }
+
+    // Переносит элементы в буфер ёмкостью new_capacity >= size_. Даёт строгую гарантию
+    constexpr void SetCapacity(size_t new_capacity) {
+        assert(new_capacity >= size_ && new_capacity != 0);
+        StatsPolicy::template OnReallocation<T>(data_.Capacity(), new_capacity);
+        if constexpr (CAN_REALLOCATE) {
+            data_.Reallocate(new_capacity);
+            return;
+        }
+        Storage new_data(new_capacity, data_.GetAllocator());
+
+        if constexpr (IsTriviallyRelocatable<T>::value) {
+            Relocate(data_.GetAddress(), size_, new_data.GetAddress());
+        }
+        else {
+            MoveOrCopyN(data_.GetAddress(), size_, new_data.GetAddress());
+            std::destroy_n(data_.GetAddress(), size_);
+        }
+        data_.Swap(new_data);
+    }
+
+    // Присваивает элементам вектора значения из [src, src + count), помещающиеся в текущую ёмкость.
+    // get преобразует исходный элемент в ссылку нужной категории (копирование или перемещение)
+    template <typename U, typename Getter>
+    constexpr void AssignElements(U* src, size_t count, Getter get) {
+        assert(count <= data_.Capacity());
+        size_t n_to_assign = std::min(size_, count);
+        for (size_t i = 0; i != n_to_assign; ++i) {
+            data_[i] = get(src[i]);
+        }
+        if (count > size_) {
+            for (size_t i = size_; i != count; ++i) {
+                std::construct_at(data_.GetAddress() + i, get(src[i]));
+                ++size_;
+            }
+        }
+        else {
+            std::destroy_n(data_.GetAddress() + count, size_ - count);
+        }
+        size_ = count;
+    }
+
     template <typename... Args>
-    iterator EmplaceNoAlloc(const_iterator pos, Args&&... args) {
+    constexpr iterator EmplaceNoAlloc(const_iterator pos, Args&&... args) {
         size_t i_pos = std::distance(cbegin(), pos);
-        if (size_ != i_pos) {
-            new (end()) T(std::forward<T>(*(end() - 1)));
-            std::move_backward(begin() + i_pos, end() - 1, end());
-            data_[i_pos] = T(std::forward<Args>(args)...);
+        if (size_ == i_pos) {
+            std::construct_at(end(), std::forward<Args>(args)...);
+            ++size_;
+        }
+        else if constexpr (IS_DIRECT_ASSIGNABLE<Args...>) {
+            // Присваивание не выбрасывает исключений, поэтому значение записывается сразу на место
+            AssignShifted(i_pos, std::forward<Args>(args)...);
         }
         else {
-            new (begin() + i_pos) T(std::forward<Args>(args)...);
+            // Значение создаётся до сдвига: это сохраняет вектор неизменным при исключении
+            // в конструкторе и защищает от аргументов, ссылающихся на сдвигаемые элементы
+            T value(std::forward<Args>(args)...);
+            ShiftTailRight(i_pos);
+            data_[i_pos] = std::move(value);
         }
-        ++size_;
         return begin() + i_pos;
     }
 
+    // Истинно, если Emplace с такими аргументами сводится к присваиванию элемента того же типа,
+    // которое не выбрасывает исключений
+    template <typename... Args>
+    static constexpr bool IS_DIRECT_ASSIGNABLE = [] {
+        if constexpr (sizeof...(Args) == 1) {
+            return (std::is_same_v<std::remove_cvref_t<Args>, T> && ...)
+                   && (std::is_nothrow_assignable_v<T&, Args&&> && ...);
+        }
+        else {
+            return false;
+        }
+    }();
+
+    // Сдвигает хвост и присваивает value освободившейся позиции i_pos без временного объекта.
+    // Если value — элемент самого вектора, после сдвига он оказывается на одну позицию правее
+    template <typename U>
+    constexpr void AssignShifted(size_t i_pos, U&& value) {
+        if (std::is_constant_evaluated()) {
+            // На этапе компиляции нельзя сравнивать адреса разных объектов
+            T value_copy(std::forward<U>(value));
+            ShiftTailRight(i_pos);
+            data_[i_pos] = std::move(value_copy);
+            return;
+        }
+        T* source = const_cast<T*>(std::addressof(value));
+        if (source >= begin() + i_pos && source < end()) {
+            ++source;
+        }
+        ShiftTailRight(i_pos);
+        data_[i_pos] = std::forward<U>(*source);
+    }
+
+    // Сдвигает элементы [i_pos, size_) на одну позицию вправо в неинициализированную ячейку end()
+    // и увеличивает размер. В позиции i_pos остаётся объект в состоянии "после перемещения".
+    // Размер увеличивается сразу после создания нового последнего элемента, чтобы он не потерялся,
+    // если исключение выбросит присваивание перемещением
+    constexpr void ShiftTailRight(size_t i_pos) {
+        std::construct_at(end(), std::move(*(end() - 1)));
+        ++size_;
+        std::move_backward(begin() + i_pos, end() - 2, end() - 1);
+    }
+
     template <typename... Args>
-    iterator EmplaceNewAlloc(const_iterator pos, Args&&... args) {
+    constexpr iterator EmplaceNewAlloc(const_iterator pos, Args&&... args) {
         size_t i_pos = std::distance(cbegin(), pos);
-        size_t new_size;
-        if (size_ == 0) {
-            new_size = 1;
+        if constexpr (CAN_REALLOCATE) {
+            size_t new_size = GrowthPolicy::NextCapacity(size_, sizeof(T));
+            assert(new_size > size_);
+            // Аргументы могут ссылаться на элементы вектора, поэтому значение создаётся до расширения буфера
+            T value(std::forward<Args>(args)...);
+            StatsPolicy::template OnReallocation<T>(data_.Capacity(), new_size);
+            data_.Reallocate(new_size);
+            T* slot = data_.GetAddress() + i_pos;
+            if (i_pos != size_) {
+                std::memmove(static_cast<void*>(slot + 1), static_cast<const void*>(slot), (size_ - i_pos) * sizeof(T));
+            }
+            std::construct_at(slot, std::move(value));
+            ++size_;
+            return slot;
         }
         else {
-            new_size = size_ * 2;
+            // Новый элемент создаётся в новом буфере до переноса старых, пока аргументы ещё действительны
+            return InsertNewAlloc(i_pos, 1, [&args...](T* dst) {
+                std::construct_at(dst, std::forward<Args>(args)...);
+            });
         }
-        RawMemory<T> new_data(new_size);
+    }
 
-        size_t count_before = std::distance(cbegin(), pos);
-        size_t count_after = std::distance(pos, cend());
+    // Вставляет n элементов в позицию i_pos, размещая вектор в новом буфере. Даёт строгую гарантию.
+    // construct(dst) создаёт n вставляемых элементов в неинициализированной памяти dst
+    // и при исключении сам разрушает уже созданные
+    template <typename Construct>
+    constexpr iterator InsertNewAlloc(size_t i_pos, size_t n, Construct construct) {
+        size_t new_capacity = std::max(size_ + n, GrowthPolicy::NextCapacity(size_, sizeof(T)));
+        StatsPolicy::template OnReallocation<T>(data_.Capacity(), new_capacity);
+        Storage new_data(new_capacity, data_.GetAllocator());
+        T* dst = new_data.GetAddress();
 
-        new (new_data.GetAddress() + i_pos) T(std::forward<Args>(args)...);
-        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-            std::uninitialized_move_n(begin(), count_before, new_data.GetAddress());
-            std::uninitialized_move_n(begin() + count_before, count_after, new_data.GetAddress() + count_before + 1);
+        construct(dst + i_pos);
+        if constexpr (IsTriviallyRelocatable<T>::value) {
+            Relocate(begin(), i_pos, dst);
+            Relocate(begin() + i_pos, size_ - i_pos, dst + i_pos + n);
         }
         else {
-            std::uninitialized_copy_n(begin(), count_before, new_data.GetAddress());
-            std::uninitialized_copy_n(begin() + count_before, count_after, new_data.GetAddress() + count_before + 1);
+            try {
+                MoveOrCopyN(begin(), i_pos, dst);
+            } catch (...) {
+                std::destroy_n(dst + i_pos, n);
+                throw;
+            }
+            try {
+                MoveOrCopyN(begin() + i_pos, size_ - i_pos, dst + i_pos + n);
+            } catch (...) {
+                std::destroy_n(dst, i_pos + n);
+                throw;
+            }
+            std::destroy_n(begin(), size_);
         }
-        std::destroy_n(begin(), size_);
         data_.Swap(new_data);
-        ++size_;
+        size_ += n;
         return begin() + i_pos;
     }
 
-    static void DestroyN(T* buf, size_t n) noexcept {
+    // Вставляет n элементов в позицию i_pos без перевыделения, сдвигая хвост один раз.
+    // construct(dst, offset, count) создаёт в неинициализированной памяти элементы источника
+    // с номерами [offset, offset + count), assign(dst, offset, count) присваивает их существующим.
+    // Для тривиально перемещаемых T даёт строгую гарантию, для остальных — базовую
+    template <typename Construct, typename Assign>
+    constexpr void InsertNoAlloc(size_t i_pos, size_t n, Construct construct, Assign assign) {
+        T* pos = begin() + i_pos;
+        T* old_end = end();
+        size_t n_after = size_ - i_pos;
+
+        if constexpr (IsTriviallyRelocatable<T>::value) {
+            if (!std::is_constant_evaluated()) {
+                std::memmove(static_cast<void*>(pos + n), static_cast<const void*>(pos), n_after * sizeof(T));
+                try {
+                    construct(pos, 0, n);
+                } catch (...) {
+                    std::memmove(static_cast<void*>(pos), static_cast<const void*>(pos + n), n_after * sizeof(T));
+                    throw;
+                }
+                size_ += n;
+                return;
+            }
+        }
+        if (n_after > n) {
+            vector_detail::UninitializedMove(old_end - n, old_end, old_end);
+            size_ += n;
+            std::move_backward(pos, old_end - n, old_end);
+            assign(pos, 0, n);
+        }
+        else {
+            construct(old_end, n_after, n - n_after);
+            size_ += n - n_after;
+            vector_detail::UninitializedMove(pos, old_end, pos + n);
+            size_ += n_after;
+            assign(pos, 0, n_after);
+        }
+    }
+
+    // Копирует n элементов, начиная с first, в неинициализированную память dst.
+    // Тривиально копируемые элементы из непрерывной памяти копируются одним вызовом memcpy
+    template <typename InputIt>
+    static constexpr void CopyConstructN(InputIt first, size_t n, T* dst) {
+        if constexpr (std::contiguous_iterator<InputIt> && std::is_same_v<std::iter_value_t<InputIt>, T>
+                      && std::is_trivially_copyable_v<T>) {
+            if (!std::is_constant_evaluated()) {
+                if (n != 0) {
+                    std::memcpy(static_cast<void*>(dst), static_cast<const void*>(std::to_address(first)), n * sizeof(T));
+                }
+                return;
+            }
+        }
+        vector_detail::UninitializedCopyN(first, n, dst);
+    }
+
+    // Создаёт в неинициализированной памяти to копии n элементов, перемещая их,
+    // если перемещение не выбрасывает исключений
+    static constexpr void MoveOrCopyN(T* from, size_t n, T* to) {
+        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+            vector_detail::UninitializedMoveN(from, n, to);
+            StatsPolicy::template OnMoved<T>(n);
+        }
+        else {
+            vector_detail::UninitializedCopyN(from, n, to);
+            StatsPolicy::template OnCopied<T>(n);
+        }
+    }
+
+    // Побайтово переносит n объектов в неинициализированную память to.
+    // После вызова объекты в from считаются несуществующими, деструкторы для них не вызываются.
+    static constexpr void Relocate(T* from, size_t n, T* to) noexcept {
+        static_assert(IsTriviallyRelocatable<T>::value);
+        if (n != 0) {
+            if (std::is_constant_evaluated()) {
+                vector_detail::UninitializedMoveN(from, n, to);
+                std::destroy_n(from, n);
+            }
+            else {
+                std::memcpy(static_cast<void*>(to), static_cast<const void*>(from), n * sizeof(T));
+            }
+            StatsPolicy::template OnRelocated<T>(n);
+        }
+    }
+
+    static constexpr void DestroyN(T* buf, size_t n) noexcept {
         for (size_t i = 0; i != n; ++i) {
             Destroy(buf + i);
         }
     }
 
-    static void CopyConstruct(T* buf, const T& elem) {
-        new (buf) T(elem);
+    static constexpr void CopyConstruct(T* buf, const T& elem) {
+        std::construct_at(buf, elem);
     }
 
-    static void Destroy(T* buf) noexcept {
-        buf->~T();
+    static constexpr void Destroy(T* buf) noexcept {
+        std::destroy_at(buf);
     }
 };
+
+// Вектор, данные которого можно напрямую передавать в выровненные SIMD-загрузки
+template <typename T, size_t Alignment = CACHE_LINE_SIZE>
+using AlignedVector = Vector<T, AlignedAllocator<T, Alignment>>;
@@ -0,0 +1,322 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+// Массовые алгоритмы над непрерывными диапазонами арифметических элементов (Vector, SmallVector,
+// столбцы SoAVector, std::span). Ядра записаны на векторных расширениях GCC/Clang блоками
+// по 64 байта и компилируются в несколько вариантов под разные наборы инструкций:
+// на x86 вариант AVX-512 или AVX2 выбирается при первом вызове по возможностям процессора,
+// на AArch64 базовый вариант уже использует NEON. Загрузки допускают невыровненные адреса;
+// на буферах AlignedAllocator они попадают ровно в кэш-линии.
+
+namespace simd_detail {
+
+// Типы, допустимые как элементы векторных расширений
+template <typename T>
+concept SimdElement = std::is_arithmetic_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, long double>;
+
+inline constexpr size_t BLOCK_SIZE = 64;
+
+template <typename T>
+using Block [[gnu::vector_size(BLOCK_SIZE)]] = T;
+
+template <typename T>
+inline constexpr size_t LANES = BLOCK_SIZE / sizeof(T);
+
+// Маска сравнения: целочисленные дорожки той же ширины, -1 там, где условие истинно
+template <typename T>
+using MaskBlock = decltype(Block<T>{} == Block<T>{});
+
+template <typename T>
+[[gnu::always_inline]] inline void Load(Block<T>& block, const T* p) noexcept {
+    std::memcpy(&block, p, BLOCK_SIZE);
+}
+
+template <typename T>
+[[gnu::always_inline]] inline bool AnyLane(const MaskBlock<T>& mask) noexcept {
+    Block<uint64_t> words;
+    std::memcpy(&words, &mask, BLOCK_SIZE);
+    uint64_t any = 0;
+    for (size_t i = 0; i != LANES<uint64_t>; ++i) {
+        any |= words[i];
+    }
+    return any != 0;
+}
+
+// Индекс первого элемента p[i] != q[i] или n
+template <typename T>
+[[gnu::always_inline]] inline size_t Mismatch(const T* p, const T* q, size_t n) noexcept {
+    size_t i = 0;
+    for (; i + LANES<T> <= n; i += LANES<T>) {
+        Block<T> a, b;
+        Load<T>(a, p + i);
+        Load<T>(b, q + i);
+        if (AnyLane<T>(a != b)) {
+            break;
+        }
+    }
+    while (i != n && p[i] == q[i]) {
+        ++i;
+    }
+    return i;
+}
+
+struct FindKernel {
+    template <typename T>
+    [[gnu::always_inline]] size_t operator()(const T* p, size_t n, T value) const noexcept {
+        const Block<T> needle = Block<T>{} + value;
+        size_t i = 0;
+        for (; i + LANES<T> <= n; i += LANES<T>) {
+            Block<T> block;
+            Load<T>(block, p + i);
+            if (AnyLane<T>(block == needle)) {
+                break;
+            }
+        }
+        while (i != n && !(p[i] == value)) {
+            ++i;
+        }
+        return i;
+    }
+};
+
+struct CountKernel {
+    template <typename T>
+    [[gnu::always_inline]] size_t operator()(const T* p, size_t n, T value) const noexcept {
+        // Совпадение вычитает единицу из дорожки счётчика; счётчики сбрасываются
+        // в общий итог раньше, чем переполнится самая узкая (8-битная) дорожка
+        const size_t FLUSH_INTERVAL = 127;
+        const Block<T> needle = Block<T>{} + value;
+        size_t count = 0;
+        size_t i = 0;
+        while (i + LANES<T> <= n) {
+            MaskBlock<T> counters = {};
+            for (size_t round = 0; round != FLUSH_INTERVAL && i + LANES<T> <= n; ++round, i += LANES<T>) {
+                Block<T> block;
+                Load<T>(block, p + i);
+                counters += block == needle;
+            }
+            for (size_t lane = 0; lane != LANES<T>; ++lane) {
+                count += static_cast<size_t>(-static_cast<int64_t>(counters[lane]));
+            }
+        }
+        for (; i != n; ++i) {
+            count += p[i] == value;
+        }
+        return count;
+    }
+};
+
+struct MinMaxKernel {
+    template <typename T>
+    [[gnu::always_inline]] std::pair<T, T> operator()(const T* p, size_t n) const noexcept {
+        T min = p[0];
+        T max = p[0];
+        size_t i = 0;
+        if (n >= LANES<T>) {
+            Block<T> block_min, block_max;
+            Load<T>(block_min, p);
+            block_max = block_min;
+            for (i = LANES<T>; i + LANES<T> <= n; i += LANES<T>) {
+                Block<T> block;
+                Load<T>(block, p + i);
+                block_min = block < block_min ? block : block_min;
+                block_max = block > block_max ? block : block_max;
+            }
+            min = block_min[0];
+            max = block_max[0];
+            for (size_t lane = 1; lane != LANES<T>; ++lane) {
+                min = block_min[lane] < min ? block_min[lane] : min;
+                max = block_max[lane] > max ? block_max[lane] : max;
+            }
+        }
+        for (; i != n; ++i) {
+            min = p[i] < min ? p[i] : min;
+            max = p[i] > max ? p[i] : max;
+        }
+        return {min, max};
+    }
+};
+
+// Сумма целых считается в 64-битных дорожках, поэтому не переполняется на узких типах
+template <typename T>
+using SumType = std::conditional_t<std::is_floating_point_v<T>, T,
+                                   std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>>;
+
+struct SumKernel {
+    template <typename T>
+    [[gnu::always_inline]] SumType<T> operator()(const T* p, size_t n) const noexcept {
+        using Acc = SumType<T>;
+        using WideBlock [[gnu::vector_size(LANES<T> * sizeof(Acc))]] = Acc;
+        WideBlock acc = {};
+        size_t i = 0;
+        for (; i + LANES<T> <= n; i += LANES<T>) {
+            Block<T> block;
+            Load<T>(block, p + i);
+            acc += __builtin_convertvector(block, WideBlock);
+        }
+        Acc sum = 0;
+        for (size_t lane = 0; lane != LANES<T>; ++lane) {
+            sum += acc[lane];
+        }
+        for (; i != n; ++i) {
+            sum += p[i];
+        }
+        return sum;
+    }
+};
+
+struct FillKernel {
+    template <typename T>
+    [[gnu::always_inline]] void operator()(T* p, size_t n, T value) const noexcept {
+        const Block<T> block = Block<T>{} + value;
+        size_t i = 0;
+        for (; i + LANES<T> <= n; i += LANES<T>) {
+            std::memcpy(p + i, &block, BLOCK_SIZE);
+        }
+        for (; i != n; ++i) {
+            p[i] = value;
+        }
+    }
+};
+
+struct MismatchKernel {
+    template <typename T>
+    [[gnu::always_inline]] size_t operator()(const T* p, const T* q, size_t n) const noexcept {
+        return Mismatch(p, q, n);
+    }
+};
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define VECTOR_SIMD_DISPATCH 1
+
+enum class SimdLevel { GENERIC, AVX2, AVX512 };
+
+inline SimdLevel DetectSimdLevel() noexcept {
+    static const SimdLevel level = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+            return SimdLevel::AVX512;
+        }
+        if (__builtin_cpu_supports("avx2")) {
+            return SimdLevel::AVX2;
+        }
+        return SimdLevel::GENERIC;
+    }();
+    return level;
+}
+
+// Ядро встраивается в каждую обёртку и компилируется с её набором инструкций
+template <typename Kernel, typename... Args>
+[[gnu::target("avx512f,avx512bw")]] auto RunAvx512(Args... args) noexcept {
+    return Kernel{}(args...);
+}
+
+template <typename Kernel, typename... Args>
+[[gnu::target("avx2")]] auto RunAvx2(Args... args) noexcept {
+    return Kernel{}(args...);
+}
+#endif
+
+template <typename Kernel, typename... Args>
+auto Run(Args... args) noexcept {
+#ifdef VECTOR_SIMD_DISPATCH
+    switch (DetectSimdLevel()) {
+        case SimdLevel::AVX512:
+            return RunAvx512<Kernel>(args...);
+        case SimdLevel::AVX2:
+            return RunAvx2<Kernel>(args...);
+        case SimdLevel::GENERIC:
+            break;
+    }
+#endif
+    return Kernel{}(args...);
+}
+
+}  // namespace simd_detail
+
+// Непрерывный диапазон, к которому применимы векторные ядра
+template <typename Range>
+concept ArithmeticRange = std::ranges::contiguous_range<Range> && std::ranges::sized_range<Range>
+                          && simd_detail::SimdElement<std::ranges::range_value_t<Range>>;
+
+// Первый элемент, равный value, или конец диапазона
+template <ArithmeticRange Range>
+auto Find(Range&& range, std::ranges::range_value_t<Range> value) noexcept {
+    using T = std::ranges::range_value_t<Range>;
+    const T* p = std::ranges::data(range);
+    return std::ranges::begin(range)
+           + simd_detail::Run<simd_detail::FindKernel>(p, std::ranges::size(range), value);
+}
+
+template <ArithmeticRange Range>
+size_t Count(const Range& range, std::ranges::range_value_t<Range> value) noexcept {
+    return simd_detail::Run<simd_detail::CountKernel>(std::ranges::data(range), std::ranges::size(range), value);
+}
+
+// Наименьший и наибольший элементы непустого диапазона. Для чисел с плавающей точкой
+// результат не определён, если в диапазоне есть NaN
+template <ArithmeticRange Range>
+auto MinMax(const Range& range) noexcept {
+    assert(std::ranges::size(range) != 0);
+    return simd_detail::Run<simd_detail::MinMaxKernel>(std::ranges::data(range), std::ranges::size(range));
+}
+
+// Целые суммируются в int64_t или uint64_t. Числа с плавающей точкой суммируются по дорожкам,
+// поэтому порядок сложения и погрешность отличаются от последовательного std::accumulate
+template <ArithmeticRange Range>
+auto Sum(const Range& range) noexcept {
+    return simd_detail::Run<simd_detail::SumKernel>(std::ranges::data(range), std::ranges::size(range));
+}
+
+template <ArithmeticRange Range>
+void Fill(Range&& range, std::ranges::range_value_t<Range> value) noexcept {
+    simd_detail::Run<simd_detail::FillKernel>(std::ranges::data(range), std::ranges::size(range), value);
+}
+
+// Целые сравниваются через memcmp; числа с плавающей точкой — поэлементно по правилам ==,
+// поэтому 0.0 равно -0.0, а NaN не равен ничему
+template <ArithmeticRange Lhs, ArithmeticRange Rhs>
+    requires std::is_same_v<std::ranges::range_value_t<Lhs>, std::ranges::range_value_t<Rhs>>
+bool Equal(const Lhs& lhs, const Rhs& rhs) noexcept {
+    using T = std::ranges::range_value_t<Lhs>;
+    const size_t n = std::ranges::size(lhs);
+    if (n != std::ranges::size(rhs)) {
+        return false;
+    }
+    if (n == 0) {
+        return true;
+    }
+    if constexpr (std::has_unique_object_representations_v<T>) {
+        return std::memcmp(std::ranges::data(lhs), std::ranges::data(rhs), n * sizeof(T)) == 0;
+    }
+    else {
+        return simd_detail::Run<simd_detail::MismatchKernel>(std::ranges::data(lhs), std::ranges::data(rhs), n) == n;
+    }
+}
+
+// Лексикографическое сравнение с результатом как у std::lexicographical_compare_three_way
+template <ArithmeticRange Lhs, ArithmeticRange Rhs>
+    requires std::is_same_v<std::ranges::range_value_t<Lhs>, std::ranges::range_value_t<Rhs>>
+auto LexicographicCompare(const Lhs& lhs, const Rhs& rhs) noexcept {
+    using T = std::ranges::range_value_t<Lhs>;
+    const T* p = std::ranges::data(lhs);
+    const T* q = std::ranges::data(rhs);
+    const size_t lhs_size = std::ranges::size(lhs);
+    const size_t rhs_size = std::ranges::size(rhs);
+    const size_t common = std::min(lhs_size, rhs_size);
+    const size_t i = common == 0 ? 0 : simd_detail::Run<simd_detail::MismatchKernel>(p, q, common);
+    using Result = std::compare_three_way_result_t<T>;
+    if (i != common) {
+        return static_cast<Result>(p[i] <=> q[i]);
+    }
+    return static_cast<Result>(lhs_size <=> rhs_size);
+}
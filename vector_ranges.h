@@ -0,0 +1,45 @@
+#pragma once
+#include "vector.h"
+
+#include <ranges>
+
+// Vector — непрерывный диапазон C++20: его можно передавать в std::ranges и std::views,
+// а конвейеры представлений материализуются в Vector одним проходом через Collect.
+static_assert(std::ranges::contiguous_range<Vector<int>> && std::ranges::sized_range<Vector<int>>);
+static_assert(std::ranges::contiguous_range<const Vector<int>>);
+static_assert(std::same_as<std::ranges::range_value_t<Vector<int>>, int>);
+
+namespace ranges_detail {
+
+template <typename VectorType, typename Range>
+using CollectResult = std::conditional_t<std::is_void_v<VectorType>, Vector<std::ranges::range_value_t<Range>>,
+                                         VectorType>;
+
+template <typename VectorType>
+struct CollectAdaptor {};
+
+}  // namespace ranges_detail
+
+// Собирает элементы диапазона в новый вектор. По умолчанию тип элементов — range_value_t диапазона.
+// Для sized_range память выделяется ровно под размер один раз, например для
+// v | std::views::transform(f) | std::views::take(n)
+template <typename VectorType = void, std::ranges::input_range Range>
+ranges_detail::CollectResult<VectorType, Range> Collect(Range&& range) {
+    ranges_detail::CollectResult<VectorType, Range> result;
+    if constexpr (std::ranges::sized_range<Range>) {
+        result.Reserve(static_cast<size_t>(std::ranges::size(range)));
+    }
+    result.AppendRange(std::forward<Range>(range));
+    return result;
+}
+
+// Форма для конвейера: range | std::views::filter(pred) | Collect()
+template <typename VectorType = void>
+ranges_detail::CollectAdaptor<VectorType> Collect() noexcept {
+    return {};
+}
+
+template <std::ranges::input_range Range, typename VectorType>
+ranges_detail::CollectResult<VectorType, Range> operator|(Range&& range, ranges_detail::CollectAdaptor<VectorType>) {
+    return Collect<VectorType>(std::forward<Range>(range));
+}
@@ -0,0 +1,112 @@
+#pragma once
+#include "vector.h"
+
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+
+// Двоичный формат для векторов тривиально копируемых элементов: заголовок из магического числа,
+// размера элемента и числа элементов, затем байты элементов как они лежат в памяти.
+// Порядок байтов и представление элементов — как на машине, записавшей данные.
+
+namespace serialization_detail {
+
+struct Header {
+    uint64_t magic;
+    uint64_t element_size;
+    uint64_t size;
+};
+
+inline constexpr uint64_t MAGIC = 0x3152455356454356;  // "VCEVSER1"
+
+// Число байтов до конца потока или nullopt, если поток не поддерживает позиционирование
+inline std::optional<uint64_t> RemainingBytes(std::istream& in) {
+    const std::istream::pos_type pos = in.tellg();
+    if (pos == std::istream::pos_type(-1)) {
+        return std::nullopt;
+    }
+    in.seekg(0, std::ios::end);
+    const std::istream::pos_type end = in.tellg();
+    in.seekg(pos);
+    if (end == std::istream::pos_type(-1) || !in) {
+        in.clear();
+        in.seekg(pos);
+        return std::nullopt;
+    }
+    return static_cast<uint64_t>(end - pos);
+}
+
+// Читает size элементов из потока неизвестной длины. Буфер растёт порциями по мере чтения,
+// поэтому испорченный заголовок не приводит к выделению памяти сверх пришедших данных
+template <typename VectorType>
+VectorType ReadInChunks(std::istream& in, size_t size, const typename VectorType::allocator_type& alloc) {
+    using T = std::remove_pointer_t<typename VectorType::iterator>;
+    constexpr size_t CHUNK_SIZE = std::max<size_t>(1, (size_t{1} << 20) / sizeof(T));
+    VectorType v(alloc);
+    while (v.Size() != size) {
+        std::span<T> chunk = v.AppendUninitialized(std::min(size - v.Size(), CHUNK_SIZE));
+        if (!in.read(reinterpret_cast<char*>(chunk.data()), static_cast<std::streamsize>(chunk.size_bytes()))) {
+            throw std::runtime_error("Deserialize: truncated data");
+        }
+    }
+    return v;
+}
+
+}  // namespace serialization_detail
+
+// Пишет заголовок и содержимое буфера; элементы передаются потоку одной записью без копирования
+template <typename T, typename Allocator, typename GrowthPolicy, typename StatsPolicy>
+void Serialize(std::ostream& out, const Vector<T, Allocator, GrowthPolicy, StatsPolicy>& v) {
+    static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable elements can be serialized");
+    const serialization_detail::Header header{serialization_detail::MAGIC, sizeof(T), v.Size()};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (v.Size() != 0) {
+        out.write(reinterpret_cast<const char*>(v.Data()), static_cast<std::streamsize>(v.Size() * sizeof(T)));
+    }
+    if (!out) {
+        throw std::runtime_error("Serialize: write failed");
+    }
+}
+
+// Читает вектор, записанный Serialize. Если длина потока известна, буфер выделяется ровно под размер
+// после проверки, что данных хватает, и заполняется одним чтением без предварительной инициализации
+// элементов; иначе элементы читаются порциями с обычным ростом вектора. Выбрасывает
+// std::runtime_error, если заголовок не соответствует типу или данные обрываются
+template <typename VectorType>
+VectorType Deserialize(std::istream& in, const typename VectorType::allocator_type& alloc = {}) {
+    using T = std::remove_pointer_t<typename VectorType::iterator>;
+    static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable elements can be deserialized");
+    using AllocTraits = std::allocator_traits<typename VectorType::allocator_type>;
+
+    serialization_detail::Header header{};
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        throw std::runtime_error("Deserialize: truncated header");
+    }
+    if (header.magic != serialization_detail::MAGIC || header.element_size != sizeof(T)) {
+        throw std::runtime_error("Deserialize: header does not match the element type");
+    }
+    if (header.size > AllocTraits::max_size(alloc)) {
+        throw std::runtime_error("Deserialize: size is too large");
+    }
+    const size_t size = static_cast<size_t>(header.size);
+    if (size == 0) {
+        return VectorType(alloc);
+    }
+    const std::optional<uint64_t> remaining = serialization_detail::RemainingBytes(in);
+    if (!remaining) {
+        return serialization_detail::ReadInChunks<VectorType>(in, size, alloc);
+    }
+    if (*remaining / sizeof(T) < header.size) {
+        throw std::runtime_error("Deserialize: truncated data");
+    }
+    typename VectorType::allocator_type buffer_alloc(alloc);
+    T* data = AllocTraits::allocate(buffer_alloc, size);
+    if (!in.read(reinterpret_cast<char*>(data), static_cast<std::streamsize>(size * sizeof(T)))) {
+        AllocTraits::deallocate(buffer_alloc, data, size);
+        throw std::runtime_error("Deserialize: truncated data");
+    }
+    return VectorType::Adopt(data, size, size, buffer_alloc);
+}
@@ -0,0 +1,161 @@
+#pragma once
+#include "vector.h"
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <typeinfo>
+
+// Счётчики операций всех векторов с одним типом элементов
+struct VectorCounters {
+    std::atomic<size_t> allocations = 0;
+    std::atomic<size_t> deallocations = 0;
+    std::atomic<size_t> bytes_allocated = 0;
+    std::atomic<size_t> reallocations = 0;
+    std::atomic<size_t> elements_moved = 0;
+    std::atomic<size_t> elements_copied = 0;
+    std::atomic<size_t> elements_relocated = 0;
+    std::atomic<size_t> peak_capacity = 0;
+    // Суммарные размер и ёмкость векторов на момент освобождения их буферов:
+    // отношение показывает, какая доля памяти тратилась на запас
+    std::atomic<size_t> released_size = 0;
+    std::atomic<size_t> released_capacity = 0;
+};
+
+// Глобальный реестр счётчиков, сгруппированных по имени типа элементов
+class VectorStatsRegistry {
+public:
+    static VectorStatsRegistry& Instance() {
+        static VectorStatsRegistry registry;
+        return registry;
+    }
+
+    // Возвращает счётчики для типа; ссылка остаётся действительной всё время работы программы
+    VectorCounters& Get(std::string_view type_name) {
+        std::lock_guard guard(mutex_);
+        auto& counters = counters_[std::string(type_name)];
+        if (!counters) {
+            counters = std::make_unique<VectorCounters>();
+        }
+        return *counters;
+    }
+
+    void Dump(std::ostream& out) const {
+        std::lock_guard guard(mutex_);
+        for (const auto& [type_name, counters] : counters_) {
+            const size_t released_size = counters->released_size.load();
+            const size_t released_capacity = counters->released_capacity.load();
+            out << type_name << ": allocations " << counters->allocations << ", deallocations "
+                << counters->deallocations << ", bytes allocated " << counters->bytes_allocated
+                << ", reallocations " << counters->reallocations << ", moved " << counters->elements_moved
+                << ", copied " << counters->elements_copied << ", relocated " << counters->elements_relocated
+                << ", peak capacity " << counters->peak_capacity << ", capacity/size ";
+            if (released_size != 0) {
+                out << static_cast<double>(released_capacity) / static_cast<double>(released_size);
+            }
+            else {
+                out << "n/a";
+            }
+            out << '\n';
+        }
+    }
+
+    // Обнуляет счётчики, сохраняя выданные ссылки на них
+    void Reset() {
+        std::lock_guard guard(mutex_);
+        for (auto& [type_name, counters] : counters_) {
+            for (std::atomic<size_t>* counter :
+                 {&counters->allocations, &counters->deallocations, &counters->bytes_allocated,
+                  &counters->reallocations, &counters->elements_moved, &counters->elements_copied,
+                  &counters->elements_relocated, &counters->peak_capacity, &counters->released_size,
+                  &counters->released_capacity}) {
+                counter->store(0);
+            }
+        }
+    }
+
+private:
+    VectorStatsRegistry() = default;
+
+    mutable std::mutex mutex_;
+    std::map<std::string, std::unique_ptr<VectorCounters>, std::less<>> counters_;
+};
+
+// Имя типа в читаемом виде. Для GCC и Clang извлекается из сигнатуры функции,
+// для остальных компиляторов используется typeid
+template <typename T>
+std::string_view TypeName() {
+#if defined(__GNUC__)
+    std::string_view signature = __PRETTY_FUNCTION__;
+    const std::string_view prefix = "T = ";
+    size_t first = signature.find(prefix);
+    if (first != std::string_view::npos) {
+        first += prefix.size();
+        size_t last = signature.find_first_of(";]", first);
+        return signature.substr(first, last - first);
+    }
+#endif
+    return typeid(T).name();
+}
+
+// Политика статистики, записывающая операции в VectorStatsRegistry.
+// Счётчики типа находятся в реестре один раз, дальше обновляются атомарно без блокировок
+struct CountingStats {
+    template <typename T>
+    static VectorCounters& Counters() {
+        static VectorCounters& counters = VectorStatsRegistry::Instance().Get(TypeName<T>());
+        return counters;
+    }
+
+    template <typename T>
+    static void OnAllocate(size_t n) noexcept {
+        VectorCounters& counters = Counters<T>();
+        counters.allocations.fetch_add(1, std::memory_order_relaxed);
+        counters.bytes_allocated.fetch_add(n * sizeof(T), std::memory_order_relaxed);
+        size_t peak = counters.peak_capacity.load(std::memory_order_relaxed);
+        while (peak < n && !counters.peak_capacity.compare_exchange_weak(peak, n, std::memory_order_relaxed)) {
+        }
+    }
+
+    template <typename T>
+    static void OnDeallocate(size_t /*n*/) noexcept {
+        Counters<T>().deallocations.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Первое выделение памяти пустым вектором перевыделением не считается
+    template <typename T>
+    static void OnReallocation(size_t old_capacity, size_t /*new_capacity*/) noexcept {
+        if (old_capacity != 0) {
+            Counters<T>().reallocations.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    template <typename T>
+    static void OnMoved(size_t n) noexcept {
+        Counters<T>().elements_moved.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    template <typename T>
+    static void OnCopied(size_t n) noexcept {
+        Counters<T>().elements_copied.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    template <typename T>
+    static void OnRelocated(size_t n) noexcept {
+        Counters<T>().elements_relocated.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    template <typename T>
+    static void OnRelease(size_t size, size_t capacity) noexcept {
+        VectorCounters& counters = Counters<T>();
+        counters.released_size.fetch_add(size, std::memory_order_relaxed);
+        counters.released_capacity.fetch_add(capacity, std::memory_order_relaxed);
+    }
+};
+
+template <typename T, typename Allocator = std::allocator<T>, typename GrowthPolicy = DoublingGrowth>
+using CountedVector = Vector<T, Allocator, GrowthPolicy, CountingStats>;